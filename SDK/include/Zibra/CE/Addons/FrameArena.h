@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Zibra/CE/Compression.h>
+
+namespace Zibra::CE::Addons
+{
+    /**
+     * Owns buffers of single SparseFrame and reuses them for every next frame.
+     * Buffers only grow, geometrically, so sequence of similarly sized frames stops allocating after first few frames.
+     * Frame returned by AllocateFrame stays valid until next AllocateFrame or Release call.
+     */
+    class FrameArena
+    {
+    public:
+        FrameArena() noexcept = default;
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /**
+         * Prepares frame with buffers for requested number of elements. Counts of the frame are set, other fields are reset.
+         * Contents of blocks, channelIndexPerBlock and spatialInfo are left from previous frames and must be fully overwritten.
+         * orderedChannels are reset to default values.
+         */
+        [[nodiscard]] Compression::SparseFrame* AllocateFrame(size_t blocksCount, size_t spatialInfoCount, size_t channelsCount) noexcept
+        {
+            Reserve(m_Blocks, m_BlocksCapacity, blocksCount);
+            Reserve(m_ChannelIndexPerBlock, m_ChannelIndexPerBlockCapacity, blocksCount);
+            Reserve(m_SpatialInfo, m_SpatialInfoCapacity, spatialInfoCount);
+            Reserve(m_OrderedChannels, m_OrderedChannelsCapacity, channelsCount);
+            std::fill_n(m_OrderedChannels.get(), channelsCount, Compression::ChannelInfo{});
+            m_ChannelNames.resize(std::max(m_ChannelNames.size(), channelsCount));
+
+            m_Frame = {};
+            m_Frame.blocksCount = blocksCount;
+            m_Frame.blocks = m_Blocks.get();
+            m_Frame.channelIndexPerBlock = m_ChannelIndexPerBlock.get();
+            m_Frame.spatialInfoCount = spatialInfoCount;
+            m_Frame.spatialInfo = m_SpatialInfo.get();
+            m_Frame.orderedChannelsCount = channelsCount;
+            m_Frame.orderedChannels = m_OrderedChannels.get();
+            return &m_Frame;
+        }
+
+        // Writable views of buffers of the frame returned by last AllocateFrame call.
+        ChannelBlock* GetBlocks() noexcept
+        {
+            return m_Blocks.get();
+        }
+        uint32_t* GetChannelIndexPerBlock() noexcept
+        {
+            return m_ChannelIndexPerBlock.get();
+        }
+        SpatialBlockInfo* GetSpatialInfo() noexcept
+        {
+            return m_SpatialInfo.get();
+        }
+        Compression::ChannelInfo* GetOrderedChannels() noexcept
+        {
+            return m_OrderedChannels.get();
+        }
+
+        // Copies channel name to arena owned storage, that reuses its memory between frames.
+        const char* StoreChannelName(size_t channelIdx, const std::string& name) noexcept
+        {
+            m_ChannelNames[channelIdx] = name;
+            return m_ChannelNames[channelIdx].c_str();
+        }
+
+        // Frees all buffers. Frame returned by last AllocateFrame call becomes invalid.
+        void Release() noexcept
+        {
+            m_Frame = {};
+            m_Blocks.reset();
+            m_ChannelIndexPerBlock.reset();
+            m_SpatialInfo.reset();
+            m_OrderedChannels.reset();
+            m_BlocksCapacity = 0;
+            m_ChannelIndexPerBlockCapacity = 0;
+            m_SpatialInfoCapacity = 0;
+            m_OrderedChannelsCapacity = 0;
+            m_ChannelNames = {};
+        }
+
+    private:
+        template <typename T>
+        static void Reserve(std::unique_ptr<T[]>& buffer, size_t& capacity, size_t count) noexcept
+        {
+            if (count <= capacity)
+                return;
+
+            // Old contents are not needed, so buffer is freed before allocating bigger one to lower peak memory usage.
+            buffer.reset();
+            capacity = std::max(count, capacity * 2);
+            buffer.reset(new T[capacity]);
+        }
+
+    private:
+        Compression::SparseFrame m_Frame{};
+        std::unique_ptr<ChannelBlock[]> m_Blocks;
+        std::unique_ptr<uint32_t[]> m_ChannelIndexPerBlock;
+        std::unique_ptr<SpatialBlockInfo[]> m_SpatialInfo;
+        std::unique_ptr<Compression::ChannelInfo[]> m_OrderedChannels;
+        size_t m_BlocksCapacity = 0;
+        size_t m_ChannelIndexPerBlockCapacity = 0;
+        size_t m_SpatialInfoCapacity = 0;
+        size_t m_OrderedChannelsCapacity = 0;
+        std::vector<std::string> m_ChannelNames;
+    };
+} // namespace Zibra::CE::Addons
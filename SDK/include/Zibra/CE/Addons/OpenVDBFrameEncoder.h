@@ -1,12 +1,25 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <execution>
+#include <numeric>
+#include <thread>
+#include <type_traits>
 #include <Zibra/CE/Decompression.h>
 #include <openvdb/tools/Dense.h>
 
 #include "OpenVDBCommon.h"
+#include "SIMDUtils.h"
+
+// HalfGrid is available starting from OpenVDB 11
+#if OPENVDB_LIBRARY_MAJOR_VERSION_NUMBER >= 11
+#define ZIB_OPENVDB_HAS_HALF_GRID 1
+#else
+#define ZIB_OPENVDB_HAS_HALF_GRID 0
+#endif
 
 namespace Zibra::CE::Addons::OpenVDBUtils
 {
@@ -16,9 +29,37 @@ namespace Zibra::CE::Addons::OpenVDBUtils
         const void* decompressionPerSpatialBlockInfo;
     };
 
+    enum class GridPrecision
+    {
+        // Grids store 32 bit floats
+        Float32,
+        // Grids store 32 bit floats in memory, and are written to file with 16 bit floats
+        Float32SavedAsHalf,
+        // Scalar grids are constructed as HalfGrid directly from float16 payload, vector grids stay 32 bit.
+        // Falls back to Float32 when OpenVDB doesn't have HalfGrid.
+        Float16,
+    };
+
+    // Controls how leafs of constructed grids are built.
+    struct GridConstructionOptions
+    {
+        GridPrecision precision = GridPrecision::Float32;
+        // Voxels with every component within tolerance of background are deactivated and set to background.
+        // Leafs that are left without active voxels are dropped.
+        bool deactivateBackground = false;
+        float backgroundTolerance = 0.0f;
+        // Blocks where every component varies by no more than tolerance are stored as active tiles instead of leafs.
+        bool collapseUniformBlocks = false;
+        float uniformTolerance = 0.0f;
+    };
+
     class FrameEncoder
     {
         using float16_mem = uint16_t;
+        // Number of spatial blocks scattered to leaf slots by single task.
+        static constexpr size_t SCATTER_RANGE_SIZE = 4096;
+        // Partitions smaller than that don't pay off cost of separate tree and merge.
+        static constexpr size_t MIN_LEAFS_PER_PARTITION = 256;
         struct ChannelBlockF16Mem
         {
             float16_mem mem[SPARSE_BLOCK_VOXEL_COUNT];
@@ -27,17 +68,36 @@ namespace Zibra::CE::Addons::OpenVDBUtils
         {
             const ChannelBlockF16Mem* chBlocks[4] = {};
         };
-        struct GridIntermediate
-        {
-            GridVoxelType voxelType;
-            Legacy::Math3D::Transform transform;
-            std::map<openvdb::Coord, LeafIntermediate> leafs;
-        };
         struct VDBGridDescRef
         {
             const VDBGridDesc* desc;
             uint32_t chIdx;
         };
+        // Grid that channel is source of, and voxel component channel is written to.
+        struct ChannelGridRef
+        {
+            uint32_t gridIdx;
+            uint32_t chIdx;
+        };
+        // Entry of per channel dispatch table, indexed by channel bit of spatial block channel mask.
+        struct ChannelDispatch
+        {
+            // Range in m_ChannelGridRefs
+            uint32_t firstGridRef = 0;
+            uint32_t gridRefsCount = 0;
+            // Mask of lower channel bits, used to find channel block of this channel in spatial block.
+            uint32_t lowerChannelsMask = 0;
+            const Decompression::ChannelInfo* chInfo = nullptr;
+        };
+        struct GridState
+        {
+            GridVoxelType voxelType = GridVoxelType::Float1;
+            // First source channel present in frame, its transform is used for the grid.
+            const Decompression::ChannelInfo* chInfo = nullptr;
+            openvdb::GridBase::Ptr grid;
+            // Spatial block indices of current chunk that have leaf in this grid.
+            std::vector<uint32_t> usedSlots;
+        };
 
     public:
         explicit FrameEncoder(const VDBGridDesc* gridsDescs, size_t gridsCount, const Decompression::FrameInfo& fInfo,
@@ -46,18 +106,21 @@ namespace Zibra::CE::Addons::OpenVDBUtils
         {
             m_GridDescs.insert(m_GridDescs.begin(), gridsDescs, gridsDescs + gridsCount);
 
+            std::map<std::string, std::vector<VDBGridDescRef>> chNameToGridDescs{};
+            m_Grids.resize(m_GridDescs.size());
             for (size_t i = 0; i < m_GridDescs.size(); ++i)
             {
                 const auto& gridDesc = m_GridDescs[i];
+                m_Grids[i].voxelType = gridDesc.voxelType;
                 switch (gridDesc.voxelType)
                 {
                 case GridVoxelType::Float1:
-                    ResolveChGridToGridDescItem(m_ChNameToGridDescs, gridDesc, 0);
+                    ResolveChGridToGridDescItem(chNameToGridDescs, gridDesc, 0);
                     break;
                 case GridVoxelType::Float3:
-                    ResolveChGridToGridDescItem(m_ChNameToGridDescs, gridDesc, 0);
-                    ResolveChGridToGridDescItem(m_ChNameToGridDescs, gridDesc, 1);
-                    ResolveChGridToGridDescItem(m_ChNameToGridDescs, gridDesc, 2);
+                    ResolveChGridToGridDescItem(chNameToGridDescs, gridDesc, 0);
+                    ResolveChGridToGridDescItem(chNameToGridDescs, gridDesc, 1);
+                    ResolveChGridToGridDescItem(chNameToGridDescs, gridDesc, 2);
                     break;
                 default:
                     assert(0 && "Unsupported grid voxel type");
@@ -67,7 +130,6 @@ namespace Zibra::CE::Addons::OpenVDBUtils
             for (size_t i = 0; i < m_FrameInfo.channelsCount; ++i)
             {
                 auto& frameInfo = m_FrameInfo.channels[i];
-                m_ChNameToChInfo[m_FrameInfo.channels[i].name] = &m_FrameInfo.channels[i];
                 if (encodingMetadata != nullptr)
                 {
                     int offsetX = encodingMetadata->offsetX;
@@ -76,6 +138,25 @@ namespace Zibra::CE::Addons::OpenVDBUtils
                     frameInfo.gridTransform =
                         Legacy::Math3D::Transform::Translation(Legacy::Math3D::float3(-offsetX, -offsetY, -offsetZ)) * frameInfo.gridTransform;
                 }
+
+                // Channel names are resolved once, so encoding only does array lookups by channel index.
+                ChannelDispatch& dispatch = m_ChannelDispatch[i];
+                dispatch.firstGridRef = static_cast<uint32_t>(m_ChannelGridRefs.size());
+                dispatch.lowerChannelsMask = (1u << i) - 1;
+                dispatch.chInfo = &frameInfo;
+                auto gridRefsIt = chNameToGridDescs.find(frameInfo.name);
+                if (gridRefsIt == chNameToGridDescs.end())
+                    continue;
+                for (const VDBGridDescRef& gridRef : gridRefsIt->second)
+                {
+                    const auto gridIdx = static_cast<uint32_t>(gridRef.desc - m_GridDescs.data());
+                    m_ChannelGridRefs.push_back(ChannelGridRef{gridIdx, gridRef.chIdx});
+                    if (!m_Grids[gridIdx].chInfo)
+                        m_Grids[gridIdx].chInfo = dispatch.chInfo;
+                }
+                dispatch.gridRefsCount = static_cast<uint32_t>(m_ChannelGridRefs.size()) - dispatch.firstGridRef;
+                if (dispatch.gridRefsCount != 0)
+                    m_DispatchedChannels[m_DispatchedChannelsCount++] = static_cast<uint32_t>(i);
             }
         }
 
@@ -84,160 +165,376 @@ namespace Zibra::CE::Addons::OpenVDBUtils
         {
             using PackedSpatialBlockInfo = Decompression::Shaders::PackedSpatialBlockInfo;
 
-            std::map<std::string, GridIntermediate> gridsIntermediate{};
             const auto* packedSpatialInfo = static_cast<const PackedSpatialBlockInfo*>(fData.decompressionPerSpatialBlockInfo);
             const auto* channelBlocksSrc = static_cast<const ChannelBlockF16Mem*>(fData.decompressionPerChannelBlockData);
 
-            int offsetX = 0;
-            int offsetY = 0;
-            int offsetZ = 0;
+            openvdb::Coord blockOffset{0, 0, 0};
             if (encodingMetadata != nullptr)
             {
-                offsetX = encodingMetadata->offsetX / SPARSE_BLOCK_SIZE;
-                offsetY = encodingMetadata->offsetY / SPARSE_BLOCK_SIZE;
-                offsetZ = encodingMetadata->offsetZ / SPARSE_BLOCK_SIZE;
+                blockOffset = openvdb::Coord{encodingMetadata->offsetX / SPARSE_BLOCK_SIZE, encodingMetadata->offsetY / SPARSE_BLOCK_SIZE,
+                                             encodingMetadata->offsetZ / SPARSE_BLOCK_SIZE};
             }
 
-            for (size_t spatialIdx = 0; spatialIdx < spatialBlocksCount; ++spatialIdx)
-            {
-                size_t localChannelBlockIdx = 0;
-                for (size_t i = 0; i < MAX_CHANNEL_COUNT; ++i)
+            // Every spatial block has unique coordinates, so leaf of each grid is addressed by spatial block index.
+            // Slots of all grids live in single array that is reused between chunks.
+            m_LeafSlots.assign(m_Grids.size() * spatialBlocksCount, LeafIntermediate{});
+
+            // Each spatial block only writes its own slots, so ranges of blocks are scattered in parallel.
+            const size_t scatterRangesCount = (spatialBlocksCount + SCATTER_RANGE_SIZE - 1) / SCATTER_RANGE_SIZE;
+            m_ScatterRanges.resize(scatterRangesCount);
+            std::iota(m_ScatterRanges.begin(), m_ScatterRanges.end(), 0);
+            std::for_each(
+                #if !ZIB_TARGET_OS_MAC
+                std::execution::par_unseq, 
+                #endif
+                m_ScatterRanges.begin(), m_ScatterRanges.end(), [&](size_t rangeIdx) {
+                const size_t rangeEnd = std::min(spatialBlocksCount, (rangeIdx + 1) * SCATTER_RANGE_SIZE);
+                for (size_t spatialIdx = rangeIdx * SCATTER_RANGE_SIZE; spatialIdx < rangeEnd; ++spatialIdx)
                 {
-                    const auto& curSpatialInfo = Decompression::UnpackPackedSpatialBlockInfo(packedSpatialInfo[spatialIdx]);
-                    openvdb::Coord blockCoord{curSpatialInfo.coords[0] + offsetX, curSpatialInfo.coords[1] + offsetY,
-                                              curSpatialInfo.coords[2] + offsetZ};
-                    if (curSpatialInfo.channelMask & (1 << i))
+                    const uint32_t channelMask = packedSpatialInfo[spatialIdx].channelMask;
+                    const size_t channelBlocksOffset = packedSpatialInfo[spatialIdx].channelBlocksOffset - chunkChBlocksFirstIndex;
+                    // Only channels used by some grid are visited
+                    for (uint32_t j = 0; j < m_DispatchedChannelsCount; ++j)
                     {
-                        const char* chName = m_FrameInfo.channels[i].name;
+                        const uint32_t channelIdx = m_DispatchedChannels[j];
+                        if ((channelMask & (1u << channelIdx)) == 0)
+                            continue;
 
-                        auto gridRefIt = m_ChNameToGridDescs.find(chName);
-                        if (gridRefIt != m_ChNameToGridDescs.end())
+                        const ChannelDispatch& dispatch = m_ChannelDispatch[channelIdx];
+                        // Channel blocks are stored for every channel in mask, including ones that are not used by any grid
+                        const size_t localChannelBlockIdx = CountBits(channelMask & dispatch.lowerChannelsMask);
+                        const ChannelBlockF16Mem* chBlock = &channelBlocksSrc[channelBlocksOffset + localChannelBlockIdx];
+
+                        const ChannelGridRef* gridRefs = &m_ChannelGridRefs[dispatch.firstGridRef];
+                        for (uint32_t k = 0; k < dispatch.gridRefsCount; ++k)
                         {
-                            const Decompression::ChannelInfo& chInfo = *m_ChNameToChInfo[chName];
-                            for (const VDBGridDescRef& gridRef : gridRefIt->second)
-                            {
-                                const char* targetGridName = gridRef.desc->gridName;
-
-                                // Find grid intermediate by name or create empty if it is absent
-                                const auto gridIntermediateToCreate = GridIntermediate{gridRef.desc->voxelType, chInfo.gridTransform, {}};
-                                auto gridIntermediateIt = gridsIntermediate.find(targetGridName);
-                                if (gridIntermediateIt == gridsIntermediate.end())
-                                    gridIntermediateIt = gridsIntermediate.insert({targetGridName, gridIntermediateToCreate}).first;
-
-                                // Find leaf intermediate in grid intermediate or create if it is absent
-                                auto leafIntermediateMapIt = gridIntermediateIt->second.leafs.find(blockCoord);
-                                if (leafIntermediateMapIt == gridIntermediateIt->second.leafs.end())
-                                    leafIntermediateMapIt = gridIntermediateIt->second.leafs.insert({blockCoord, {}}).first;
-
-                                const size_t chBlcIdx = curSpatialInfo.channelBlocksOffset + localChannelBlockIdx - chunkChBlocksFirstIndex;
-                                leafIntermediateMapIt->second.chBlocks[gridRef.chIdx] = &channelBlocksSrc[chBlcIdx];
-                            }
-                            ++localChannelBlockIdx;
+                            const ChannelGridRef& gridRef = gridRefs[k];
+                            m_LeafSlots[gridRef.gridIdx * spatialBlocksCount + spatialIdx].chBlocks[gridRef.chIdx] = chBlock;
                         }
                     }
                 }
-            }
+            });
 
+            // Used slots are collected per grid afterwards, so they stay in spatial block order without synchronization.
             std::for_each(
                 #if !ZIB_TARGET_OS_MAC
                 std::execution::par_unseq, 
                 #endif
-                gridsIntermediate.begin(), gridsIntermediate.end(), [&](auto& gridIt) {
-                auto outGridIt = m_Grids.find(gridIt.first);
-                if (outGridIt == m_Grids.end())
-                    outGridIt = m_Grids.insert({gridIt.first, nullptr}).first;
+                m_Grids.begin(), m_Grids.end(), [&](GridState& gridState) {
+                const size_t gridIdx = &gridState - m_Grids.data();
+                const LeafIntermediate* leafSlots = &m_LeafSlots[gridIdx * spatialBlocksCount];
+                gridState.usedSlots.clear();
+                for (size_t spatialIdx = 0; spatialIdx < spatialBlocksCount; ++spatialIdx)
+                {
+                    if (!IsEmptyLeafSlot(leafSlots[spatialIdx]))
+                        gridState.usedSlots.push_back(static_cast<uint32_t>(spatialIdx));
+                }
+            });
+
+            const auto constructionStart = std::chrono::steady_clock::now();
+            std::for_each(
+                #if !ZIB_TARGET_OS_MAC
+                std::execution::par_unseq, 
+                #endif
+                m_Grids.begin(), m_Grids.end(), [&](GridState& gridState) {
+                if (gridState.usedSlots.empty())
+                    return;
 
-                switch (gridIt.second.voxelType)
+                const size_t gridIdx = &gridState - m_Grids.data();
+                const LeafIntermediate* leafSlots = &m_LeafSlots[gridIdx * spatialBlocksCount];
+                switch (gridState.voxelType)
                 {
                 case GridVoxelType::Float1: {
-                    ConstructGrid<openvdb::FloatGrid>(gridIt.second, &outGridIt->second);
+#if ZIB_OPENVDB_HAS_HALF_GRID
+                    if (m_ConstructionOptions.precision == GridPrecision::Float16)
+                    {
+                        ConstructGrid<openvdb::HalfGrid>(gridState, leafSlots, packedSpatialInfo, blockOffset);
+                        break;
+                    }
+#endif
+                    ConstructGrid<openvdb::FloatGrid>(gridState, leafSlots, packedSpatialInfo, blockOffset);
                     break;
                 }
                 case GridVoxelType::Float3: {
-                    ConstructGrid<openvdb::Vec3fGrid>(gridIt.second, &outGridIt->second);
+                    ConstructGrid<openvdb::Vec3fGrid>(gridState, leafSlots, packedSpatialInfo, blockOffset);
                     break;
                 }
                 default:
                     assert(0 && "Unsupported grid voxel type");
                 }
             });
+            m_GridConstructionTime += std::chrono::steady_clock::now() - constructionStart;
         }
 
+        // Must be set before first EncodeChunk call, since precision can't change after grids are created.
+        void SetConstructionOptions(const GridConstructionOptions& options) noexcept
+        {
+            m_ConstructionOptions = options;
+        }
+
+        // Time spent constructing leafs and adding them to grids, summed over all encoded chunks.
+        std::chrono::steady_clock::duration GetGridConstructionTime() const noexcept
+        {
+            return m_GridConstructionTime;
+        }
+
+        // Transform of grids constructed from channel, including decode offset.
+        openvdb::math::Transform::Ptr GetChannelTransform(size_t chIdx) const noexcept
+        {
+            return SanitizeTransform(m_FrameInfo.channels[chIdx].gridTransform);
+        }
+
+        // Grids that have at least one leaf, sorted by name.
+        // Encoder keeps its references, so following EncodeChunk calls keep adding leafs to the returned grids.
         openvdb::GridPtrVec GetGrids() noexcept
         {
             openvdb::GridPtrVec result{};
             result.reserve(m_Grids.size());
-            for (const auto& [gridName, grid] : m_Grids)
+            for (size_t i = 0; i < m_Grids.size(); ++i)
+            {
+                if (!m_Grids[i].grid)
+                    continue;
+                m_Grids[i].grid->setName(m_GridDescs[i].gridName);
+                result.emplace_back(m_Grids[i].grid);
+            }
+            std::sort(result.begin(), result.end(), [](const openvdb::GridBase::Ptr& a, const openvdb::GridBase::Ptr& b) {
+                return a->getName() < b->getName();
+            });
+            return result;
+        }
+
+        // Same as GetGrids, but moves grids out instead of copying pointers.
+        // Encoder keeps no references to returned grids and following EncodeChunk calls start new grids.
+        openvdb::GridPtrVec ReleaseGrids() noexcept
+        {
+            openvdb::GridPtrVec result{};
+            result.reserve(m_Grids.size());
+            for (size_t i = 0; i < m_Grids.size(); ++i)
             {
-                grid->setName(gridName);
-                result.emplace_back(grid);
+                if (!m_Grids[i].grid)
+                    continue;
+                m_Grids[i].grid->setName(m_GridDescs[i].gridName);
+                result.emplace_back(std::move(m_Grids[i].grid));
+                m_Grids[i].grid = nullptr;
             }
+            std::sort(result.begin(), result.end(), [](const openvdb::GridBase::Ptr& a, const openvdb::GridBase::Ptr& b) {
+                return a->getName() < b->getName();
+            });
             return result;
         }
     private:
         template<typename GridT>
-        void ConstructGrid(const GridIntermediate& gridIntermediate, openvdb::GridBase::Ptr* inoutGrid) noexcept
+        void ConstructGrid(GridState& gridState, const LeafIntermediate* leafSlots,
+                           const Decompression::Shaders::PackedSpatialBlockInfo* packedSpatialInfo, const openvdb::Coord& blockOffset) noexcept
         {
-            auto inoutGridTyped = *inoutGrid ? openvdb::gridPtrCast<GridT>(*inoutGrid) : GridT::create();
-            if (!*inoutGrid)
+            auto gridTyped = gridState.grid ? openvdb::gridPtrCast<GridT>(gridState.grid) : GridT::create();
+            if (!gridState.grid)
             {
-                inoutGridTyped->setTransform(SanitizeTransform(gridIntermediate.transform));
+                gridTyped->setTransform(SanitizeTransform(gridState.chInfo->gridTransform));
+                if (m_ConstructionOptions.precision == GridPrecision::Float32SavedAsHalf)
+                    gridTyped->setSaveFloatAsHalf(true);
             }
 
-            std::mutex gridAccessMutex{};
-            const auto& leafIntermediates = gridIntermediate.leafs;
+            using TreeT = typename GridT::TreeType;
+
+            // Each partition adds its leafs and tiles to its own tree, so no lock is needed.
+            // Used slots are in spatial block order, so contiguous partitions share few internal nodes.
+            const size_t usedSlotsCount = gridState.usedSlots.size();
+            const size_t maxPartitionCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            const size_t partitionCount = std::clamp<size_t>(usedSlotsCount / MIN_LEAFS_PER_PARTITION, 1, maxPartitionCount);
+            std::vector<TreeT> partitionTrees(partitionCount);
+            std::vector<size_t> partitionIndices(partitionCount);
+            std::iota(partitionIndices.begin(), partitionIndices.end(), 0);
+
             std::for_each(
                 #if !ZIB_TARGET_OS_MAC
                 std::execution::par_unseq, 
                 #endif
-                leafIntermediates.begin(), leafIntermediates.end(), [&](auto leafIt) {
-                using TreeT = typename GridT::TreeType;
-                using LeafT = typename TreeT::LeafNodeType;
-                LeafT* leaf = ConstructLeaf<LeafT>(leafIt.first, leafIt.second, gridIntermediate.voxelType);
-
-                std::lock_guard guard{gridAccessMutex};
-                inoutGridTyped->tree().addLeaf(leaf);
+                partitionIndices.begin(), partitionIndices.end(), [&](size_t partitionIdx) {
+                const size_t firstSlot = usedSlotsCount * partitionIdx / partitionCount;
+                const size_t lastSlot = usedSlotsCount * (partitionIdx + 1) / partitionCount;
+                TreeT& partitionTree = partitionTrees[partitionIdx];
+                for (size_t i = firstSlot; i < lastSlot; ++i)
+                {
+                    const uint32_t spatialIdx = gridState.usedSlots[i];
+                    const auto spatialInfo = Decompression::UnpackPackedSpatialBlockInfo(packedSpatialInfo[spatialIdx]);
+                    const openvdb::Coord leafCoord =
+                        openvdb::Coord{spatialInfo.coords[0], spatialInfo.coords[1], spatialInfo.coords[2]} + blockOffset;
+                    ConstructLeaf(partitionTree, leafCoord, leafSlots[spatialIdx], gridState.voxelType);
+                }
             });
-            *inoutGrid = inoutGridTyped;
+
+            // Partitions have disjoint leafs and tiles, so merge only moves nodes between trees.
+            // Pairs are merged in parallel, halving number of trees every pass.
+            for (size_t stride = 1; stride < partitionCount; stride *= 2)
+            {
+                std::vector<size_t> mergeTargets{};
+                for (size_t i = 0; i + stride < partitionCount; i += stride * 2)
+                {
+                    mergeTargets.push_back(i);
+                }
+                std::for_each(
+                    #if !ZIB_TARGET_OS_MAC
+                    std::execution::par_unseq, 
+                    #endif
+                    mergeTargets.begin(), mergeTargets.end(), [&](size_t targetIdx) {
+                    partitionTrees[targetIdx].merge(partitionTrees[targetIdx + stride], openvdb::MERGE_ACTIVE_STATES);
+                });
+            }
+            gridTyped->tree().merge(partitionTrees[0], openvdb::MERGE_ACTIVE_STATES);
+            gridState.grid = gridTyped;
         }
 
-        template<typename LeafT>
-        LeafT* ConstructLeaf(const openvdb::Coord& leafCoord, const LeafIntermediate& leafIntermediate, GridVoxelType voxelType) noexcept
+        template <typename TreeT>
+        void ConstructLeaf(TreeT& tree, const openvdb::Coord& leafCoord, const LeafIntermediate& leafIntermediate,
+                           GridVoxelType voxelType) noexcept
         {
+            switch (voxelType)
+            {
+            case GridVoxelType::Float1:
+                ConstructBlock<1>(tree, leafCoord, leafIntermediate);
+                break;
+            case GridVoxelType::Float3:
+                if constexpr (!IsHalfValue<typename TreeT::ValueType>())
+                    ConstructBlock<3>(tree, leafCoord, leafIntermediate);
+                else
+                    assert(0 && "Half grids are only constructed from scalar channels");
+                break;
+            default:
+                assert(0 && "Unsupported grid voxel type");
+            }
+        }
+
+        // Adds leaf, tile or nothing to the tree, depending on block values and construction options.
+        // Values are converted on stack, so leaf is only allocated for blocks that end up as leafs.
+        template <size_t ComponentCount, typename TreeT>
+        void ConstructBlock(TreeT& tree, const openvdb::Coord& leafCoord, const LeafIntermediate& leafIntermediate) noexcept
+        {
+            using LeafT = typename TreeT::LeafNodeType;
+            using ValueT = typename TreeT::ValueType;
+            static constexpr bool IS_HALF_LEAF = IsHalfValue<ValueT>();
+
             const openvdb::Coord blockMin = {leafCoord.x() * SPARSE_BLOCK_SIZE, leafCoord.y() * SPARSE_BLOCK_SIZE,
                                              leafCoord.z() * SPARSE_BLOCK_SIZE};
-            auto* leaf = new LeafT{openvdb::PartialCreate{}, blockMin, {}, true};
-            leaf->allocate();
-            float* leafBuf = reinterpret_cast<float*>(leaf->buffer().data());
 
             static constexpr ChannelBlockF16Mem zeroedBlock = {};
 
-            switch (voxelType)
+            // Half leafs take float16 payload as is, converted values are only needed to find active voxels and uniform blocks.
+            alignas(32) float values[SPARSE_BLOCK_VOXEL_COUNT * ComponentCount];
+            const bool isCollapseEnabled = m_ConstructionOptions.collapseUniformBlocks;
+            const bool needsValues = !IS_HALF_LEAF || isCollapseEnabled || m_ConstructionOptions.deactivateBackground;
+
+            // Range of values is computed in the same pass as conversion
+            bool isUniform = isCollapseEnabled;
+            float tileValue[3] = {};
+            for (size_t c = 0; c < ComponentCount && needsValues; ++c)
             {
-            case GridVoxelType::Float1: {
-                static constexpr size_t compCount = 1;
-                CopyToStrided(leafBuf, leafIntermediate.chBlocks[0] ? *leafIntermediate.chBlocks[0] : zeroedBlock, compCount, 0);
-                break;
-            }
-            case GridVoxelType::Float3: {
-                static constexpr size_t compCount = 3;
-                CopyToStrided(leafBuf, leafIntermediate.chBlocks[0] ? *leafIntermediate.chBlocks[0] : zeroedBlock, compCount, 0);
-                CopyToStrided(leafBuf, leafIntermediate.chBlocks[1] ? *leafIntermediate.chBlocks[1] : zeroedBlock, compCount, 1);
-                CopyToStrided(leafBuf, leafIntermediate.chBlocks[2] ? *leafIntermediate.chBlocks[2] : zeroedBlock, compCount, 2);
-                break;
+                const ChannelBlockF16Mem& src = leafIntermediate.chBlocks[c] ? *leafIntermediate.chBlocks[c] : zeroedBlock;
+                if (!isCollapseEnabled)
+                {
+                    SIMDUtils::ConvertFloat16ToFloat32<ComponentCount>(values, src.mem, SPARSE_BLOCK_VOXEL_COUNT, c);
+                    continue;
+                }
+                SIMDUtils::ValueRange range{};
+                SIMDUtils::ConvertFloat16ToFloat32<ComponentCount>(values, src.mem, SPARSE_BLOCK_VOXEL_COUNT, c, range);
+                isUniform &= range.max - range.min <= m_ConstructionOptions.uniformTolerance;
+                tileValue[c] = 0.5f * (range.min + range.max);
             }
-            default:
-                assert(0 && "Unsupported grid voxel type");
+
+            if (isUniform)
+            {
+                if (m_ConstructionOptions.deactivateBackground && IsBackgroundVoxel<ComponentCount>(tileValue))
+                    return;
+                // Level 1 tile covers exactly one leaf
+                tree.addTile(1, blockMin, MakeValue<ValueT>(tileValue), true);
+                return;
             }
-            return leaf;
+
+            typename LeafT::NodeMaskType valueMask{true};
+            if (m_ConstructionOptions.deactivateBackground && !DeactivateBackground<ComponentCount>(values, valueMask))
+                return;
+
+            auto* leaf = new LeafT{openvdb::PartialCreate{}, blockMin, {}, true};
+            leaf->allocate();
+            leaf->setValueMask(valueMask);
+            if constexpr (IS_HALF_LEAF)
+                CopyToHalfLeaf(*leaf, leafIntermediate.chBlocks[0] ? *leafIntermediate.chBlocks[0] : zeroedBlock);
+            else
+                std::memcpy(leaf->buffer().data(), values, sizeof(values));
+            tree.addLeaf(leaf);
+        }
+        template <typename ValueT>
+        static constexpr bool IsHalfValue() noexcept
+        {
+#if ZIB_OPENVDB_HAS_HALF_GRID
+            return std::is_same_v<ValueT, openvdb::math::half>;
+#else
+            return false;
+#endif
         }
-        static void CopyToStrided(float* dst, const ChannelBlockF16Mem& src, size_t componentCount, size_t componentIdx) noexcept
+        // Copies float16 payload to half leaf, matching values produced by Float16ToFloat32. Inactive voxels are set to zero.
+        template <typename LeafT>
+        static void CopyToHalfLeaf(LeafT& leaf, const ChannelBlockF16Mem& src) noexcept
         {
+            static constexpr uint16_t SIGN_MASK = 0x8000;
+            static constexpr uint16_t EXPONENT_MASK = 0x7c00;
+
+            auto* dst = reinterpret_cast<uint16_t*>(leaf.buffer().data());
+            const auto& valueMask = leaf.getValueMask();
             for (size_t i = 0; i < SPARSE_BLOCK_VOXEL_COUNT; ++i)
             {
-                dst[i * componentCount + componentIdx] = Float16ToFloat32(src.mem[i]);
+                const uint16_t value = src.mem[i];
+                const uint16_t sign = value & SIGN_MASK;
+                const uint16_t exponent = value & EXPONENT_MASK;
+                // Denormals are flushed to zero, same as in Float16ToFloat32. Inf and NaN are copied as is,
+                // since Float16ToFloat32 propagates them too.
+                const uint16_t result = exponent == 0 ? sign : value;
+                dst[i] = valueMask.isOn(openvdb::Index(i)) ? result : uint16_t(0);
             }
         }
+        template <typename ValueT>
+        static ValueT MakeValue(const float* components) noexcept
+        {
+            if constexpr (std::is_same_v<ValueT, float> || IsHalfValue<ValueT>())
+                return ValueT(components[0]);
+            else
+                return ValueT{components[0], components[1], components[2]};
+        }
+        template <size_t ComponentCount>
+        bool IsBackgroundVoxel(const float* voxel) const noexcept
+        {
+            // Background of constructed grids is zero
+            bool isBackground = true;
+            for (size_t c = 0; c < ComponentCount; ++c)
+            {
+                isBackground &= std::abs(voxel[c]) <= m_ConstructionOptions.backgroundTolerance;
+            }
+            return isBackground;
+        }
+        // Builds value mask from block values, zeroing background voxels. Returns false when no voxel is left active.
+        // Loops are branchless, so compiler vectorizes them.
+        template <size_t ComponentCount, typename MaskT>
+        bool DeactivateBackground(float* values, MaskT& valueMask) const noexcept
+        {
+            static constexpr size_t MASK_WORD_BITS = 64;
+
+            for (openvdb::Index wordIdx = 0; wordIdx < SPARSE_BLOCK_VOXEL_COUNT / MASK_WORD_BITS; ++wordIdx)
+            {
+                uint64_t word = 0;
+                for (size_t bit = 0; bit < MASK_WORD_BITS; ++bit)
+                {
+                    float* voxel = values + (wordIdx * MASK_WORD_BITS + bit) * ComponentCount;
+                    const bool isBackground = IsBackgroundVoxel<ComponentCount>(voxel);
+                    for (size_t c = 0; c < ComponentCount; ++c)
+                    {
+                        voxel[c] = isBackground ? 0.0f : voxel[c];
+                    }
+                    word |= uint64_t(!isBackground) << bit;
+                }
+                valueMask.template getWord<uint64_t>(wordIdx) = word;
+            }
+            return !valueMask.isOff();
+        }
         static void ResolveChGridToGridDescItem(std::map<std::string, std::vector<VDBGridDescRef>>& chNameToGridDescs,
                                                 const VDBGridDesc& gridDesc, uint32_t chSrcIdx) noexcept
         {
@@ -248,6 +545,10 @@ namespace Zibra::CE::Addons::OpenVDBUtils
                 chIt = chNameToGridDescs.insert({gridDesc.chSource[chSrcIdx], {}}).first;
             chIt->second.push_back(VDBGridDescRef{&gridDesc, chSrcIdx});
         }
+        static bool IsEmptyLeafSlot(const LeafIntermediate& leafSlot) noexcept
+        {
+            return !leafSlot.chBlocks[0] && !leafSlot.chBlocks[1] && !leafSlot.chBlocks[2] && !leafSlot.chBlocks[3];
+        }
         static openvdb::math::Transform::Ptr SanitizeTransform(const Legacy::Math3D::Transform& inTransform) noexcept
         {
             bool isEmpty = true;
@@ -268,9 +569,18 @@ namespace Zibra::CE::Addons::OpenVDBUtils
     private:
         std::vector<VDBGridDesc> m_GridDescs{};
         Decompression::FrameInfo m_FrameInfo{};
-        std::map<std::string, std::vector<VDBGridDescRef>> m_ChNameToGridDescs{};
-        std::map<std::string, const Decompression::ChannelInfo*> m_ChNameToChInfo{};
+        // Grid references of all channels, grouped by channel
+        std::vector<ChannelGridRef> m_ChannelGridRefs{};
+        ChannelDispatch m_ChannelDispatch[MAX_CHANNEL_COUNT]{};
+        // Indices of channels that have at least one grid reference
+        uint32_t m_DispatchedChannels[MAX_CHANNEL_COUNT]{};
+        uint32_t m_DispatchedChannelsCount = 0;
 
-        std::map<std::string, openvdb::GridBase::Ptr> m_Grids{};
+        // Indexed same as m_GridDescs
+        std::vector<GridState> m_Grids{};
+        std::vector<LeafIntermediate> m_LeafSlots{};
+        std::vector<size_t> m_ScatterRanges{};
+        std::chrono::steady_clock::duration m_GridConstructionTime{};
+        GridConstructionOptions m_ConstructionOptions{};
     };
 } // namespace Zibra::CE::Addons::OpenVDBUtils
@@ -1,38 +1,66 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <execution>
-#include <map>
+#include <tuple>
+#include <vector>
 #include <Zibra/CE/Compression.h>
 #include <openvdb/openvdb.h>
 #include <openvdb/tools/GridTransformer.h>
+#include <openvdb/tree/LeafManager.h>
 
+#include "FrameArena.h"
 #include "OpenVDBCommon.h"
+#include "SIMDUtils.h"
 
 namespace Zibra::CE::Addons::OpenVDBUtils
 {
+    // Controls which blocks are dropped before frame reaches compressor.
+    struct BlockCullingOptions
+    {
+        // Leafs, which voxels are all within tolerance of grid background, are not packed into frame.
+        // All value components of leaf must match background, so vector grids never lose single component of the block.
+        // Spatial blocks that are left without channel blocks are dropped too.
+        // Culled leafs decode as inactive background, so active voxels inside them are deactivated.
+        bool cullBackgroundBlocks = false;
+        // Absolute difference from background in grid value units, applied to each component separately.
+        float backgroundTolerance = 0.0f;
+    };
+
     class FrameLoader
     {
         struct ChannelDescriptor
         {
             std::string name;
             ChannelMask channelMask;
-            openvdb::GridBase::Ptr grid;
+            openvdb::GridBase::ConstPtr grid;
+            // Voxelized active tiles of grid, null when grid has no active tiles
+            openvdb::GridBase::ConstPtr tileGrid;
             uint32_t valueSize;
             uint32_t valueStride;
             uint32_t valueOffset;
         };
-        struct ChannelBlockIntermediate
+        struct LeafEntry
         {
+            // Leaf origin in blocks
+            openvdb::Coord blockCoord;
+            uint32_t channelIdx;
             const void* data;
-            uint32_t valueSize;
-            uint32_t valueStride;
-            uint32_t valueOffset;
+        };
+        struct ProcessedGrid
+        {
+            openvdb::GridBase::ConstPtr grid;
+            openvdb::GridBase::ConstPtr tileGrid;
         };
         struct SpatialBlockIntermediate
         {
-            uint32_t destSpatialBlockIndex = 0;
+            openvdb::Coord blockCoord;
+            // Leaf entries of spatial block are sorted by channel and stored contiguously,
+            // so their range is also the range of destination channel blocks.
             uint32_t destFirstChannelBlockIndex = 0;
-            std::map<ChannelMask, ChannelBlockIntermediate> blocks{};
+            uint32_t channelCount = 0;
+            ChannelMask channelMask = 0;
         };
     public:
         /**
@@ -65,47 +93,24 @@ namespace Zibra::CE::Addons::OpenVDBUtils
                 }
             }
 
-            // Creating mutable grid copies for future voxelization. Resample if matchVoxelSize is enabled.
-            std::vector<openvdb::GridBase::Ptr> processedGrids{};
+            // Input grids are read in place. Only grids that need resampling are copied, and only active tiles are voxelized.
+            std::vector<ProcessedGrid> processedGrids{};
             processedGrids.resize(gridsCount);
             std::transform(
                 #if !ZIB_TARGET_OS_MAC
                 std::execution::par_unseq, 
                 #endif
                 grids, grids + gridsCount, processedGrids.begin(), [&](const auto& grid) {
-                const openvdb::math::Transform relativeTransform = GetIndexSpaceRelativeTransform(grid, originGrid);
-                openvdb::tools::GridTransformer transformer{relativeTransform.baseMap()->getAffineMap()->getMat4()};
-
-                openvdb::GridBase::Ptr mutableCopy = grid->deepCopyGrid();
-                if (mutableCopy->baseTree().isType<openvdb::Vec3STree>())
+                if (grid->baseTree().template isType<openvdb::Vec3STree>())
                 {
-                    const auto src = openvdb::gridConstPtrCast<openvdb::Vec3SGrid>(grid);
-                    const auto dst = openvdb::gridPtrCast<openvdb::Vec3SGrid>(mutableCopy);
-                    dst->tree().voxelizeActiveTiles();
-                    if (matchVoxelSize && !relativeTransform.isIdentity())
-                    {
-                        dst->clear();
-                        transformer.transformGrid<openvdb::tools::BoxSampler>(*src, *dst);
-                        dst->setTransform(originGrid->transform().copy());
-                    }
+                    return ProcessGrid<openvdb::Vec3SGrid>(grid, originGrid, matchVoxelSize);
                 }
-                else if (mutableCopy->baseTree().isType<openvdb::FloatTree>())
+                else if (grid->baseTree().template isType<openvdb::FloatTree>())
                 {
-                    const auto src = openvdb::gridConstPtrCast<openvdb::FloatGrid>(grid);
-                    const auto dst = openvdb::gridPtrCast<openvdb::FloatGrid>(mutableCopy);
-                    dst->tree().voxelizeActiveTiles();
-                    if (matchVoxelSize && !relativeTransform.isIdentity())
-                    {
-                        dst->clear();
-                        transformer.transformGrid<openvdb::tools::BoxSampler>(*src, *dst);
-                        dst->setTransform(originGrid->transform().copy());
-                    }
-                }
-                else
-                {
-                    assert(0 && "Unsupported grid type. Loader supports only floating point grids.");
+                    return ProcessGrid<openvdb::FloatGrid>(grid, originGrid, matchVoxelSize);
                 }
-                return mutableCopy;
+                assert(0 && "Unsupported grid type. Loader supports only floating point grids.");
+                return ProcessedGrid{grid, nullptr};
             });
 
             // Splitting vector grids to separate scalar channels + constructing channels unshuffle structure
@@ -114,12 +119,12 @@ namespace Zibra::CE::Addons::OpenVDBUtils
             {
                 VDBGridDesc shuffleGridInfo{};
                 std::vector<ChannelDescriptor> channels;
-                if (processedGrids[i]->baseTree().isType<openvdb::Vec3STree>())
+                if (processedGrids[i].grid->baseTree().isType<openvdb::Vec3STree>())
                 {
                     shuffleGridInfo.voxelType = GridVoxelType::Float3;
                     channels = ChannelsFromGrid(processedGrids[i], 3, sizeof(float), mask);
                 }
-                else if (processedGrids[i]->baseTree().isType<openvdb::FloatTree>())
+                else if (processedGrids[i].grid->baseTree().isType<openvdb::FloatTree>())
                 {
                     shuffleGridInfo.voxelType = GridVoxelType::Float1;
                     channels = ChannelsFromGrid(processedGrids[i], 1, sizeof(float), mask);
@@ -131,7 +136,7 @@ namespace Zibra::CE::Addons::OpenVDBUtils
                     return;
                 }
 
-                const auto& gridName = processedGrids[i]->getName();
+                const auto& gridName = processedGrids[i].grid->getName();
                 shuffleGridInfo.gridName = new char[gridName.length() + 1];
                 strcpy(const_cast<char*>(shuffleGridInfo.gridName), gridName.c_str());
 
@@ -159,23 +164,32 @@ namespace Zibra::CE::Addons::OpenVDBUtils
             }
         }
 
-        [[nodiscard]] Compression::SparseFrame* LoadFrame(EncodingMetadata* encodingMetadata = nullptr) const noexcept
+        void SetCullingOptions(const BlockCullingOptions& options) noexcept
         {
-            auto result = new Compression::SparseFrame{};
-            std::map<openvdb::Coord, SpatialBlockIntermediate> spatialBlocks{};
-            Legacy::Math3D::AABB totalAABB = {};
+            m_CullingOptions = options;
+        }
 
-            // Resolving leaf data to spatial descriptors structure for future concurrent processing.
+        /**
+         * Packs leafs of all channels into sparse frame.
+         * @param encodingMetadata - out metadata needed to decode frame back to OpenVDB grids
+         * @param arena - when set, frame buffers are taken from arena. Such frame is owned by arena and must not be passed to ReleaseFrame.
+         *                Otherwise frame is allocated on its own and must be released with ReleaseFrame.
+         */
+        [[nodiscard]] Compression::SparseFrame* LoadFrame(EncodingMetadata* encodingMetadata = nullptr,
+                                                          FrameArena* arena = nullptr) const noexcept
+        {
+            // Collecting leafs of all channels to flat array. Leafs of each grid are visited in parallel.
+            std::vector<LeafEntry> leafEntries{};
             for (size_t i = 0; i < m_Channels.size(); ++i)
             {
                 const ChannelDescriptor& channel = m_Channels[i];
                 if (channel.grid->baseTree().isType<openvdb::Vec3STree>())
                 {
-                    totalAABB = totalAABB | ResolveBlocks<openvdb::Vec3fGrid>(channel, spatialBlocks);
+                    CollectLeafs<openvdb::Vec3fGrid>(channel, static_cast<uint32_t>(i), m_CullingOptions, leafEntries);
                 }
                 else if (channel.grid->baseTree().isType<openvdb::FloatTree>())
                 {
-                    totalAABB = totalAABB | ResolveBlocks<openvdb::FloatGrid>(channel, spatialBlocks);
+                    CollectLeafs<openvdb::FloatGrid>(channel, static_cast<uint32_t>(i), m_CullingOptions, leafEntries);
                 }
                 else
                 {
@@ -184,43 +198,89 @@ namespace Zibra::CE::Addons::OpenVDBUtils
                 }
             }
 
-            // Iterating over resolved spatial descriptors and precalculating voxel data destination memory offset
-            std::vector<SpatialBlockIntermediate*> orderedSpatialBlockIntermediates{};
-            orderedSpatialBlockIntermediates.resize(spatialBlocks.size());
-            for (auto& [coord, spatialBlock] : spatialBlocks)
+            if (m_CullingOptions.cullBackgroundBlocks)
             {
-                orderedSpatialBlockIntermediates[spatialBlock.destSpatialBlockIndex] = &spatialBlock;
+                // Culled leafs are marked with null data
+                const auto isCulled = [](const LeafEntry& entry) { return !entry.data; };
+                leafEntries.erase(std::remove_if(leafEntries.begin(), leafEntries.end(), isCulled), leafEntries.end());
             }
-            uint32_t channelBlockAccumulator = 0;
-            for (auto& spatialBlock : orderedSpatialBlockIntermediates)
+
+            // Sorting merges leafs of different channels at the same position into one run, ordered by channel.
+            std::sort(
+                #if !ZIB_TARGET_OS_MAC
+                std::execution::par_unseq, 
+                #endif
+                leafEntries.begin(), leafEntries.end(), [](const LeafEntry& a, const LeafEntry& b) {
+                return std::tie(a.blockCoord, a.channelIdx) < std::tie(b.blockCoord, b.channelIdx);
+            });
+
+            std::vector<SpatialBlockIntermediate> spatialBlocks{};
+            Legacy::Math3D::AABB totalAABB = {};
+            for (size_t i = 0; i < leafEntries.size(); ++i)
             {
-                spatialBlock->destFirstChannelBlockIndex = channelBlockAccumulator;
-                channelBlockAccumulator += spatialBlock->blocks.size();
-            }
+                const LeafEntry& entry = leafEntries[i];
+                if (spatialBlocks.empty() || spatialBlocks.back().blockCoord != entry.blockCoord)
+                {
+                    SpatialBlockIntermediate& spatialBlock = spatialBlocks.emplace_back();
+                    spatialBlock.blockCoord = entry.blockCoord;
+                    spatialBlock.destFirstChannelBlockIndex = static_cast<uint32_t>(i);
 
-            result->blocksCount = channelBlockAccumulator;
-            result->spatialInfoCount = spatialBlocks.size();
-            result->orderedChannelsCount = m_Channels.size();
+                    const openvdb::Coord& coord = entry.blockCoord;
+                    const Legacy::Math3D::AABB blockAABB{coord.x(), coord.y(), coord.z(), coord.x() + 1, coord.y() + 1, coord.z() + 1};
+                    totalAABB = totalAABB | blockAABB;
+                }
+                SpatialBlockIntermediate& spatialBlock = spatialBlocks.back();
+                ++spatialBlock.channelCount;
+                spatialBlock.channelMask |= m_Channels[entry.channelIdx].channelMask;
+            }
 
             // Allocating result frame buffers from precalculated data
-            auto* resultBlocks = new ChannelBlock[result->blocksCount];
-            auto* resultChannelIndexPerBlock = new uint32_t[result->blocksCount];
-            auto* resultSpatialInfo = new SpatialBlockInfo[result->spatialInfoCount];
-            auto* orderedChannels = new Compression::ChannelInfo[result->orderedChannelsCount];
-
-            result->blocks = resultBlocks;
-            result->spatialInfo = resultSpatialInfo;
-            result->orderedChannels = orderedChannels;
-            result->channelIndexPerBlock = resultChannelIndexPerBlock;
+            Compression::SparseFrame* result = nullptr;
+            ChannelBlock* resultBlocks = nullptr;
+            uint32_t* resultChannelIndexPerBlock = nullptr;
+            SpatialBlockInfo* resultSpatialInfo = nullptr;
+            Compression::ChannelInfo* orderedChannels = nullptr;
+            if (arena)
+            {
+                result = arena->AllocateFrame(leafEntries.size(), spatialBlocks.size(), m_Channels.size());
+                resultBlocks = arena->GetBlocks();
+                resultChannelIndexPerBlock = arena->GetChannelIndexPerBlock();
+                resultSpatialInfo = arena->GetSpatialInfo();
+                orderedChannels = arena->GetOrderedChannels();
+            }
+            else
+            {
+                result = new Compression::SparseFrame{};
+                result->blocksCount = leafEntries.size();
+                result->spatialInfoCount = spatialBlocks.size();
+                result->orderedChannelsCount = m_Channels.size();
+
+                resultBlocks = new ChannelBlock[result->blocksCount];
+                resultChannelIndexPerBlock = new uint32_t[result->blocksCount];
+                resultSpatialInfo = new SpatialBlockInfo[result->spatialInfoCount];
+                orderedChannels = new Compression::ChannelInfo[result->orderedChannelsCount];
+
+                result->blocks = resultBlocks;
+                result->spatialInfo = resultSpatialInfo;
+                result->orderedChannels = orderedChannels;
+                result->channelIndexPerBlock = resultChannelIndexPerBlock;
+            }
 
             // Preparing channel info. Filling known data and setting edge initial values for future statistics calculation.
             for (size_t i = 0; i < m_Channels.size(); ++i)
             {
-                auto chName = new char[m_Channels[i].name.length() + 1];
-                strcpy(chName, m_Channels[i].name.c_str());
-                orderedChannels[i].name = chName;
+                if (arena)
+                {
+                    orderedChannels[i].name = arena->StoreChannelName(i, m_Channels[i].name);
+                }
+                else
+                {
+                    auto chName = new char[m_Channels[i].name.length() + 1];
+                    strcpy(chName, m_Channels[i].name.c_str());
+                    orderedChannels[i].name = chName;
+                }
                 orderedChannels[i].statistics.minValue = std::numeric_limits<float>::max();
-                orderedChannels[i].statistics.maxValue = std::numeric_limits<float>::min();
+                orderedChannels[i].statistics.maxValue = std::numeric_limits<float>::lowest();
 
                 auto posVoxelSpaceCompensation = openvdb::math::Vec3d(totalAABB.minX, totalAABB.minY, totalAABB.minZ) * SPARSE_BLOCK_SIZE;
                 auto translatedTransform = TranslateOpenVDBTransform(m_Channels[i].grid->constTransform(), posVoxelSpaceCompensation);
@@ -235,44 +295,26 @@ namespace Zibra::CE::Addons::OpenVDBUtils
                 #if !ZIB_TARGET_OS_MAC
                 std::execution::par_unseq, 
                 #endif
-                spatialBlocks.begin(), spatialBlocks.end(), [&](const std::pair<openvdb::Coord, SpatialBlockIntermediate>& item){
-                auto& [coord, spatialIntrm] = item;
-                ChannelMask mask = 0x0;
-
-                // Channels are ordered right way due to map soring and mask bit order.
-                size_t chIdx = 0;
-                for (auto& [chMask, chBlockIntrm] : spatialIntrm.blocks) {
-                    uint32_t channelBlockIndex = spatialIntrm.destFirstChannelBlockIndex + chIdx;
+                spatialBlocks.begin(), spatialBlocks.end(), [&](const SpatialBlockIntermediate& spatialIntrm) {
+                for (uint32_t chIdx = 0; chIdx < spatialIntrm.channelCount; ++chIdx)
+                {
+                    const uint32_t channelBlockIndex = spatialIntrm.destFirstChannelBlockIndex + chIdx;
+                    const LeafEntry& entry = leafEntries[channelBlockIndex];
+                    const ChannelDescriptor& channel = m_Channels[entry.channelIdx];
                     ChannelBlock& outBlock = resultBlocks[channelBlockIndex];
-                    mask |= chMask;
-                    resultChannelIndexPerBlock[channelBlockIndex] = FirstChannelIndexFromMask(chMask);
-                    PackFromStride(&outBlock, chBlockIntrm.data, chBlockIntrm.valueStride, chBlockIntrm.valueOffset, chBlockIntrm.valueSize,
-                                   SPARSE_BLOCK_VOXEL_COUNT);
-
-                    Compression::VoxelStatistics& dstStatistics = perBlockStatistics[channelBlockIndex];
-                    dstStatistics.minValue = std::numeric_limits<float>::max();
-                    dstStatistics.maxValue = std::numeric_limits<float>::min();
-                    for (float voxel : outBlock.voxels)
-                    {
-                        dstStatistics.minValue = std::min(dstStatistics.minValue, voxel);
-                        dstStatistics.maxValue = std::max(dstStatistics.maxValue, voxel);
-                        dstStatistics.meanPositiveValue += voxel > 0.0f ? voxel : 0.0f;
-                        dstStatistics.meanNegativeValue += voxel < 0.0f ? voxel : 0.0f;
-                    }
-                    dstStatistics.meanPositiveValue /= static_cast<float>(SPARSE_BLOCK_VOXEL_COUNT);
-                    dstStatistics.meanNegativeValue /= static_cast<float>(SPARSE_BLOCK_VOXEL_COUNT);
-
-                    ++chIdx;
+                    resultChannelIndexPerBlock[channelBlockIndex] = entry.channelIdx;
+                    perBlockStatistics[channelBlockIndex] = PackWithStatistics(&outBlock, entry.data, channel);
                 }
 
+                const openvdb::Coord& coord = spatialIntrm.blockCoord;
                 SpatialBlockInfo spatialInfo{};
                 spatialInfo.coords[0] = coord.x() - totalAABB.minX;
                 spatialInfo.coords[1] = coord.y() - totalAABB.minY;
                 spatialInfo.coords[2] = coord.z() - totalAABB.minZ;
-                spatialInfo.channelMask = mask;
-                spatialInfo.channelCount = spatialIntrm.blocks.size();
+                spatialInfo.channelMask = spatialIntrm.channelMask;
+                spatialInfo.channelCount = spatialIntrm.channelCount;
                 spatialInfo.channelBlocksOffset = spatialIntrm.destFirstChannelBlockIndex;
-                resultSpatialInfo[spatialIntrm.destSpatialBlockIndex] = spatialInfo;
+                resultSpatialInfo[&spatialIntrm - spatialBlocks.data()] = spatialInfo;
             });
 
             // Resolving concurrently calculated per block voxel statistics to general frame per channel voxel statistics.
@@ -345,39 +387,69 @@ namespace Zibra::CE::Addons::OpenVDBUtils
         }
     private:
         /**
-         * Iterates over input channel grid leafs, resolved offsets and adds transition data (SpatialBlockIntermediate) to spatialMap.
+         * Appends leafs of channel grid and its voxelized tiles to leaf entries.
          * @tparam T - OpenVDB::BasicGrid subtype
          * @param ch - Source channel grid descriptor
-         * @param spatialMap - out map SpatialBlockIntermediate descriptor will be stored in.
-         * @return Total channel AABB
+         * @param channelIdx - Index of channel in m_Channels
+         * @param cullingOptions - culled leafs are appended with null data
+         * @param leafEntries - out array entries are appended to
          */
         template <typename T>
-        Legacy::Math3D::AABB ResolveBlocks(const ChannelDescriptor& ch, std::map<openvdb::Coord, SpatialBlockIntermediate>& spatialMap) const noexcept
+        static void CollectLeafs(const ChannelDescriptor& ch, uint32_t channelIdx, const BlockCullingOptions& cullingOptions,
+                                 std::vector<LeafEntry>& leafEntries) noexcept
         {
-            auto grid = openvdb::gridPtrCast<T>(ch.grid);
+            CollectLeafs(*openvdb::gridConstPtrCast<T>(ch.grid), channelIdx, cullingOptions, leafEntries);
+            if (ch.tileGrid)
+            {
+                // Tiles and leafs of the same tree never overlap, so voxelized tiles give separate spatial blocks
+                CollectLeafs(*openvdb::gridConstPtrCast<T>(ch.tileGrid), channelIdx, cullingOptions, leafEntries);
+            }
+        }
 
-            Legacy::Math3D::AABB totalAABB = {};
-            for (auto leafIt = grid->tree().cbeginLeaf(); leafIt; ++leafIt)
+        template <typename T>
+        static void CollectLeafs(const T& grid, uint32_t channelIdx, const BlockCullingOptions& cullingOptions,
+                                 std::vector<LeafEntry>& leafEntries) noexcept
+        {
+            const openvdb::tree::LeafManager<const typename T::TreeType> leafManager{grid.tree()};
+            const size_t firstEntry = leafEntries.size();
+            leafEntries.resize(firstEntry + leafManager.leafCount());
+            std::for_each(
+                #if !ZIB_TARGET_OS_MAC
+                std::execution::par_unseq, 
+                #endif
+                leafEntries.begin() + firstEntry, leafEntries.end(), [&](LeafEntry& entry) {
+                const auto& leaf = leafManager.leaf(&entry - &leafEntries[firstEntry]);
+                const Legacy::Math3D::AABB leafAABB = CalculateAABB(leaf.getNodeBoundingBox());
+                entry.blockCoord = openvdb::Coord(leafAABB.minX, leafAABB.minY, leafAABB.minZ);
+                entry.channelIdx = channelIdx;
+                // Active state of culled leaf is not preserved, decoder leaves its voxels inactive.
+                const bool isCulled = cullingOptions.cullBackgroundBlocks &&
+                                      IsBackgroundLeaf(leaf, grid.background(), cullingOptions.backgroundTolerance);
+                entry.data = isCulled ? nullptr : leaf.buffer().data();
+            });
+        }
+
+        template <typename LeafT, typename ValueT>
+        static bool IsBackgroundLeaf(const LeafT& leaf, const ValueT& background, float tolerance) noexcept
+        {
+            const ValueT* values = leaf.buffer().data();
+            for (openvdb::Index i = 0; i < LeafT::SIZE; ++i)
             {
-                const auto leaf = leafIt.getLeaf();
-                const Legacy::Math3D::AABB leafAABB = CalculateAABB(leaf->getNodeBoundingBox());
-                totalAABB = totalAABB | leafAABB;
-                openvdb::Coord origin = openvdb::Coord(leafAABB.minX, leafAABB.minY, leafAABB.minZ);
-
-                auto slbIt = spatialMap.find(origin);
-                SpatialBlockIntermediate newBlock{static_cast<uint32_t>(spatialMap.size()), 0, {}};
-                SpatialBlockIntermediate& localSpatialBlock = slbIt == spatialMap.end() ? newBlock : slbIt->second;
-
-                ChannelBlockIntermediate localChannelBlock{};
-                localChannelBlock.data = leaf->buffer().data();
-                localChannelBlock.valueSize = ch.valueSize;
-                localChannelBlock.valueStride = ch.valueStride;
-                localChannelBlock.valueOffset = ch.valueOffset;
-                localSpatialBlock.blocks[ch.channelMask] = localChannelBlock;
-
-                spatialMap[origin] = localSpatialBlock;
+                if (!IsNearBackground(values[i], background, tolerance))
+                    return false;
             }
-            return totalAABB;
+            return true;
+        }
+
+        // NaN values are never near background, so blocks with them are kept.
+        static bool IsNearBackground(float value, float background, float tolerance) noexcept
+        {
+            return std::abs(value - background) <= tolerance;
+        }
+        static bool IsNearBackground(const openvdb::Vec3f& value, const openvdb::Vec3f& background, float tolerance) noexcept
+        {
+            return IsNearBackground(value.x(), background.x(), tolerance) && IsNearBackground(value.y(), background.y(), tolerance) &&
+                   IsNearBackground(value.z(), background.z(), tolerance);
         }
 
         static Legacy::Math3D::Transform OpenVDBTransformToMath3DTransform(const openvdb::math::Transform& transform) noexcept
@@ -408,27 +480,55 @@ namespace Zibra::CE::Addons::OpenVDBUtils
             return resultTransform;
         }
 
-        static uint32_t FirstChannelIndexFromMask(ChannelMask mask) noexcept
+        /**
+         * Resamples grid to origin grid voxel size when needed, and voxelizes its active tiles to separate grid.
+         * Source grid is never copied when it doesn't need resampling.
+         */
+        template <typename GridT>
+        static ProcessedGrid ProcessGrid(const openvdb::GridBase::ConstPtr& grid, const openvdb::GridBase::ConstPtr& originGrid,
+                                         bool matchVoxelSize) noexcept
         {
-            for (size_t i = 0; i < sizeof(mask) * 8; ++i)
+            using TreeT = typename GridT::TreeType;
+
+            typename GridT::ConstPtr src = openvdb::gridConstPtrCast<GridT>(grid);
+            const openvdb::math::Transform relativeTransform = GetIndexSpaceRelativeTransform(grid, originGrid);
+            if (matchVoxelSize && !relativeTransform.isIdentity())
             {
-                if (mask & 1 << i)
-                {
-                    return i;
-                }
+                openvdb::tools::GridTransformer transformer{relativeTransform.baseMap()->getAffineMap()->getMat4()};
+                typename GridT::Ptr resampled = openvdb::gridPtrCast<GridT>(src->copyGridWithNewTree());
+                transformer.transformGrid<openvdb::tools::BoxSampler>(*src, *resampled);
+                resampled->setTransform(originGrid->transform().copy());
+                src = resampled;
             }
-            return 0;
+
+            ProcessedGrid result{src, nullptr};
+            if (src->tree().activeTileCount() == 0)
+                return result;
+
+            // Side grid only holds voxelized tiles, so memory is only spent on tile regions
+            typename GridT::Ptr tileGrid = openvdb::gridPtrCast<GridT>(src->copyGridWithNewTree());
+            typename TreeT::ValueOnCIter tileIt = src->tree().cbeginValueOn();
+            tileIt.setMaxDepth(TreeT::ValueOnCIter::LEAF_DEPTH - 1);
+            for (; tileIt; ++tileIt)
+            {
+                tileGrid->tree().addTile(tileIt.getLevel(), tileIt.getCoord(), *tileIt, true);
+            }
+            tileGrid->tree().voxelizeActiveTiles();
+            result.tileGrid = tileGrid;
+            return result;
         }
 
-        static std::vector<ChannelDescriptor> ChannelsFromGrid(openvdb::GridBase::Ptr grid, uint32_t voxelComponentCount,
+        static std::vector<ChannelDescriptor> ChannelsFromGrid(const ProcessedGrid& processedGrid, uint32_t voxelComponentCount,
                                                                uint32_t voxelComponentSize, ChannelMask firstChMask) noexcept
         {
+            const openvdb::GridBase::ConstPtr& grid = processedGrid.grid;
             std::vector<ChannelDescriptor> result{};
             for (size_t chIdx = 0; chIdx < voxelComponentCount; ++chIdx)
             {
                 ChannelDescriptor chDesc{};
                 chDesc.name = voxelComponentCount > 1 ? SplitGridNameFromValueComponentIdx(grid->getName(), chIdx) : grid->getName();
                 chDesc.grid = grid;
+                chDesc.tileGrid = processedGrid.tileGrid;
                 chDesc.channelMask = firstChMask << chIdx;
                 chDesc.valueOffset = chIdx * voxelComponentSize;
                 chDesc.valueSize = voxelComponentSize;
@@ -456,6 +556,41 @@ namespace Zibra::CE::Addons::OpenVDBUtils
             return result;
         }
 
+        /**
+         * Copies channel values of single leaf to block and calculates block voxel statistics in the same pass.
+         * @param dst - destination block
+         * @param src - leaf voxel data
+         * @param ch - channel descriptor, that defines layout of channel values in leaf voxel data
+         * @return Block voxel statistics
+         */
+        static Compression::VoxelStatistics PackWithStatistics(ChannelBlock* dst, const void* src, const ChannelDescriptor& ch) noexcept
+        {
+            const auto* srcValues = static_cast<const float*>(src);
+            const size_t componentIdx = ch.valueOffset / sizeof(float);
+            SIMDUtils::BlockStatistics blockStatistics{};
+            switch (ch.valueStride / sizeof(float))
+            {
+            case 1:
+                SIMDUtils::PackWithStatistics<1>(dst->voxels, srcValues, SPARSE_BLOCK_VOXEL_COUNT, componentIdx, blockStatistics);
+                break;
+            case 3:
+                SIMDUtils::PackWithStatistics<3>(dst->voxels, srcValues, SPARSE_BLOCK_VOXEL_COUNT, componentIdx, blockStatistics);
+                break;
+            default:
+                // Loader only creates float and float3 channels, other layouts are packed first and then reduced in place.
+                PackFromStride(dst, src, ch.valueStride, ch.valueOffset, ch.valueSize, SPARSE_BLOCK_VOXEL_COUNT);
+                SIMDUtils::PackWithStatistics<1>(dst->voxels, dst->voxels, SPARSE_BLOCK_VOXEL_COUNT, 0, blockStatistics);
+                break;
+            }
+
+            Compression::VoxelStatistics result{};
+            result.minValue = blockStatistics.min;
+            result.maxValue = blockStatistics.max;
+            result.meanPositiveValue = blockStatistics.positiveSum / static_cast<float>(SPARSE_BLOCK_VOXEL_COUNT);
+            result.meanNegativeValue = blockStatistics.negativeSum / static_cast<float>(SPARSE_BLOCK_VOXEL_COUNT);
+            return result;
+        }
+
         static void PackFromStride(void* dst, const void* src, size_t stride, size_t offset, size_t size, size_t count) noexcept {
             if (stride == size && offset == 0) {
                 memcpy(dst, src, count * size);
@@ -518,6 +653,7 @@ namespace Zibra::CE::Addons::OpenVDBUtils
         }
 
     private:
+        BlockCullingOptions m_CullingOptions{};
         std::vector<ChannelDescriptor> m_Channels{};
         std::vector<VDBGridDesc> m_GridsShuffle{};
     };
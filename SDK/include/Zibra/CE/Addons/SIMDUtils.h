@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <Zibra/CE/Common.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ZIB_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define ZIB_SIMD_X86 0
+#endif
+
+// Functions using instructions above SSE2 are compiled for extended instruction set individually,
+// so the rest of the binary keeps running on any x86-64 CPU.
+#if ZIB_SIMD_X86 && !defined(_MSC_VER)
+#define ZIB_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ZIB_SIMD_TARGET_AVX2
+#endif
+
+namespace Zibra::CE::Addons::SIMDUtils
+{
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    struct ValueRange
+    {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+    };
+
+    struct BlockStatistics
+    {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        // Sums of positive and negative values respectively, other values contribute 0.
+        float positiveSum = 0.0f;
+        float negativeSum = 0.0f;
+    };
+
+    namespace Detail
+    {
+#if ZIB_SIMD_X86
+        inline bool IsAVX2Supported() noexcept
+        {
+            unsigned int regs[4] = {};
+#if defined(_MSC_VER)
+            int msvcRegs[4] = {};
+            __cpuid(msvcRegs, 0);
+            if (msvcRegs[0] < 7)
+                return false;
+            __cpuid(msvcRegs, 1);
+            regs[2] = static_cast<unsigned int>(msvcRegs[2]);
+#else
+            if (__get_cpuid_max(0, nullptr) < 7)
+                return false;
+            __get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+            // CPU must support AVX and OS must save YMM registers on context switch
+            static constexpr unsigned int OSXSAVE_BIT = 1u << 27;
+            static constexpr unsigned int AVX_BIT = 1u << 28;
+            if ((regs[2] & (OSXSAVE_BIT | AVX_BIT)) != (OSXSAVE_BIT | AVX_BIT))
+                return false;
+
+#if defined(_MSC_VER)
+            const uint64_t xcr0 = _xgetbv(0);
+#else
+            uint32_t xcr0Low = 0;
+            uint32_t xcr0High = 0;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            const uint64_t xcr0 = (uint64_t(xcr0High) << 32) | xcr0Low;
+#endif
+            static constexpr uint64_t XMM_YMM_STATE = 0x6;
+            if ((xcr0 & XMM_YMM_STATE) != XMM_YMM_STATE)
+                return false;
+
+#if defined(_MSC_VER)
+            __cpuidex(msvcRegs, 7, 0);
+            regs[1] = static_cast<unsigned int>(msvcRegs[1]);
+#else
+            __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+            static constexpr unsigned int AVX2_BIT = 1u << 5;
+            return (regs[1] & AVX2_BIT) != 0;
+        }
+
+        // Same bit manipulation as Float16ToFloat32, for 4 values at a time.
+        inline __m128i Float16ToFloat32Bits(__m128i float16Values) noexcept
+        {
+            const __m128i t2 = _mm_slli_epi32(_mm_and_si128(float16Values, _mm_set1_epi32(0x8000)), 16);
+            const __m128i t3 = _mm_and_si128(float16Values, _mm_set1_epi32(0x7c00));
+            __m128i t1 = _mm_slli_epi32(_mm_and_si128(float16Values, _mm_set1_epi32(0x7fff)), 13);
+            t1 = _mm_add_epi32(t1, _mm_set1_epi32(0x38000000));
+            t1 = _mm_andnot_si128(_mm_cmpeq_epi32(t3, _mm_setzero_si128()), t1);
+            t1 = _mm_add_epi32(t1, _mm_and_si128(_mm_cmpeq_epi32(t3, _mm_set1_epi32(0x7c00)), _mm_set1_epi32(0x38000000)));
+            return _mm_or_si128(t1, t2);
+        }
+
+        inline void ReduceRange(ValueRange* range, const float* minValues, const float* maxValues, size_t count) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                range->min = std::min(range->min, minValues[i]);
+                range->max = std::max(range->max, maxValues[i]);
+            }
+        }
+
+        // Converts values from first to count, that didn't fill whole vector.
+        template <size_t Stride, bool ComputeRange>
+        void ConvertTail(float* dst, const uint16_t* src, size_t first, size_t count, size_t componentIdx, ValueRange* range) noexcept
+        {
+            for (size_t i = first; i < count; ++i)
+            {
+                const float value = Float16ToFloat32(src[i]);
+                dst[i * Stride + componentIdx] = value;
+                if constexpr (ComputeRange)
+                {
+                    range->min = std::min(range->min, value);
+                    range->max = std::max(range->max, value);
+                }
+            }
+        }
+
+        // Packs values from first to count, that didn't fill whole vector.
+        // Comparisons are ordered same way as in std::min/std::max, so NaN values don't affect min and max.
+        template <size_t Stride>
+        void PackWithStatisticsTail(float* dst, const float* src, size_t first, size_t count, size_t componentIdx,
+                                    BlockStatistics* statistics) noexcept
+        {
+            for (size_t i = first; i < count; ++i)
+            {
+                const float value = src[i * Stride + componentIdx];
+                dst[i] = value;
+                statistics->min = std::min(statistics->min, value);
+                statistics->max = std::max(statistics->max, value);
+                statistics->positiveSum += value > 0.0f ? value : 0.0f;
+                statistics->negativeSum += value < 0.0f ? value : 0.0f;
+            }
+        }
+
+        inline void ReduceStatistics(BlockStatistics* statistics, const float* minValues, const float* maxValues, const float* positiveSums,
+                                     const float* negativeSums, size_t count) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                statistics->min = std::min(statistics->min, minValues[i]);
+                statistics->max = std::max(statistics->max, maxValues[i]);
+                statistics->positiveSum += positiveSums[i];
+                statistics->negativeSum += negativeSums[i];
+            }
+        }
+
+        template <size_t Stride>
+        inline void StoreStrided(float* dst, const float* values, size_t count, size_t componentIdx) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                dst[i * Stride + componentIdx] = values[i];
+            }
+        }
+
+        template <size_t Stride, bool ComputeRange>
+        void ConvertFloat16ToFloat32SSE2(float* dst, const uint16_t* src, size_t count, size_t componentIdx, ValueRange* range) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128 rangeMin = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 rangeMax = _mm_set1_ps(std::numeric_limits<float>::lowest());
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i float16Values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                const __m128 low = _mm_castsi128_ps(Float16ToFloat32Bits(_mm_unpacklo_epi16(float16Values, zero)));
+                const __m128 high = _mm_castsi128_ps(Float16ToFloat32Bits(_mm_unpackhi_epi16(float16Values, zero)));
+                if constexpr (ComputeRange)
+                {
+                    rangeMin = _mm_min_ps(rangeMin, _mm_min_ps(low, high));
+                    rangeMax = _mm_max_ps(rangeMax, _mm_max_ps(low, high));
+                }
+                if constexpr (Stride == 1)
+                {
+                    _mm_storeu_ps(dst + i, low);
+                    _mm_storeu_ps(dst + i + 4, high);
+                }
+                else
+                {
+                    alignas(16) float values[8];
+                    _mm_store_ps(values, low);
+                    _mm_store_ps(values + 4, high);
+                    StoreStrided<Stride>(dst + i * Stride, values, 8, componentIdx);
+                }
+            }
+            if constexpr (ComputeRange)
+            {
+                alignas(16) float minValues[4];
+                alignas(16) float maxValues[4];
+                _mm_store_ps(minValues, rangeMin);
+                _mm_store_ps(maxValues, rangeMax);
+                ReduceRange(range, minValues, maxValues, 4);
+            }
+            ConvertTail<Stride, ComputeRange>(dst, src, i, count, componentIdx, range);
+        }
+
+        template <size_t Stride, bool ComputeRange>
+        ZIB_SIMD_TARGET_AVX2 void ConvertFloat16ToFloat32AVX2(float* dst, const uint16_t* src, size_t count, size_t componentIdx,
+                                                              ValueRange* range) noexcept
+        {
+            const __m256i signMask = _mm256_set1_epi32(0x8000);
+            const __m256i exponentMask = _mm256_set1_epi32(0x7c00);
+            const __m256i nonSignMask = _mm256_set1_epi32(0x7fff);
+            const __m256i biasAdjust = _mm256_set1_epi32(0x38000000);
+            const __m256i zero = _mm256_setzero_si256();
+            __m256 rangeMin = _mm256_set1_ps(std::numeric_limits<float>::max());
+            __m256 rangeMax = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i float16Values = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+                const __m256i t2 = _mm256_slli_epi32(_mm256_and_si256(float16Values, signMask), 16);
+                const __m256i t3 = _mm256_and_si256(float16Values, exponentMask);
+                __m256i t1 = _mm256_slli_epi32(_mm256_and_si256(float16Values, nonSignMask), 13);
+                t1 = _mm256_add_epi32(t1, biasAdjust);
+                t1 = _mm256_andnot_si256(_mm256_cmpeq_epi32(t3, zero), t1);
+                t1 = _mm256_add_epi32(t1, _mm256_and_si256(_mm256_cmpeq_epi32(t3, exponentMask), biasAdjust));
+                const __m256 result = _mm256_castsi256_ps(_mm256_or_si256(t1, t2));
+                if constexpr (ComputeRange)
+                {
+                    rangeMin = _mm256_min_ps(rangeMin, result);
+                    rangeMax = _mm256_max_ps(rangeMax, result);
+                }
+                if constexpr (Stride == 1)
+                {
+                    _mm256_storeu_ps(dst + i, result);
+                }
+                else
+                {
+                    alignas(32) float values[8];
+                    _mm256_store_ps(values, result);
+                    StoreStrided<Stride>(dst + i * Stride, values, 8, componentIdx);
+                }
+            }
+            if constexpr (ComputeRange)
+            {
+                alignas(32) float minValues[8];
+                alignas(32) float maxValues[8];
+                _mm256_store_ps(minValues, rangeMin);
+                _mm256_store_ps(maxValues, rangeMax);
+                ReduceRange(range, minValues, maxValues, 8);
+            }
+            ConvertTail<Stride, ComputeRange>(dst, src, i, count, componentIdx, range);
+        }
+
+        // Min and max take value as first operand, so NaN values are skipped same as in PackWithStatisticsTail.
+        // max(value, 0) and min(value, 0) match positive and negative parts of value, including NaN that gives 0.
+        template <size_t Stride>
+        void PackWithStatisticsSSE2(float* dst, const float* src, size_t count, size_t componentIdx, BlockStatistics* statistics) noexcept
+        {
+            const __m128 zero = _mm_setzero_ps();
+            __m128 minValues = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 maxValues = _mm_set1_ps(std::numeric_limits<float>::lowest());
+            __m128 positiveSums = zero;
+            __m128 negativeSums = zero;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 values;
+                if constexpr (Stride == 1)
+                {
+                    values = _mm_loadu_ps(src + i + componentIdx);
+                }
+                else
+                {
+                    const float* first = src + i * Stride + componentIdx;
+                    values = _mm_setr_ps(first[0], first[Stride], first[2 * Stride], first[3 * Stride]);
+                }
+                _mm_storeu_ps(dst + i, values);
+                minValues = _mm_min_ps(values, minValues);
+                maxValues = _mm_max_ps(values, maxValues);
+                positiveSums = _mm_add_ps(positiveSums, _mm_max_ps(values, zero));
+                negativeSums = _mm_add_ps(negativeSums, _mm_min_ps(values, zero));
+            }
+            alignas(16) float lanes[4][4];
+            _mm_store_ps(lanes[0], minValues);
+            _mm_store_ps(lanes[1], maxValues);
+            _mm_store_ps(lanes[2], positiveSums);
+            _mm_store_ps(lanes[3], negativeSums);
+            ReduceStatistics(statistics, lanes[0], lanes[1], lanes[2], lanes[3], 4);
+            PackWithStatisticsTail<Stride>(dst, src, i, count, componentIdx, statistics);
+        }
+
+        template <size_t Stride>
+        ZIB_SIMD_TARGET_AVX2 void PackWithStatisticsAVX2(float* dst, const float* src, size_t count, size_t componentIdx,
+                                                         BlockStatistics* statistics) noexcept
+        {
+            constexpr int STRIDE = static_cast<int>(Stride);
+            const __m256i gatherIndices =
+                _mm256_setr_epi32(0, STRIDE, 2 * STRIDE, 3 * STRIDE, 4 * STRIDE, 5 * STRIDE, 6 * STRIDE, 7 * STRIDE);
+            const __m256 zero = _mm256_setzero_ps();
+            __m256 minValues = _mm256_set1_ps(std::numeric_limits<float>::max());
+            __m256 maxValues = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+            __m256 positiveSums = zero;
+            __m256 negativeSums = zero;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 values;
+                if constexpr (Stride == 1)
+                {
+                    values = _mm256_loadu_ps(src + i + componentIdx);
+                }
+                else
+                {
+                    values = _mm256_i32gather_ps(src + i * Stride + componentIdx, gatherIndices, sizeof(float));
+                }
+                _mm256_storeu_ps(dst + i, values);
+                minValues = _mm256_min_ps(values, minValues);
+                maxValues = _mm256_max_ps(values, maxValues);
+                positiveSums = _mm256_add_ps(positiveSums, _mm256_max_ps(values, zero));
+                negativeSums = _mm256_add_ps(negativeSums, _mm256_min_ps(values, zero));
+            }
+            alignas(32) float lanes[4][8];
+            _mm256_store_ps(lanes[0], minValues);
+            _mm256_store_ps(lanes[1], maxValues);
+            _mm256_store_ps(lanes[2], positiveSums);
+            _mm256_store_ps(lanes[3], negativeSums);
+            ReduceStatistics(statistics, lanes[0], lanes[1], lanes[2], lanes[3], 8);
+            PackWithStatisticsTail<Stride>(dst, src, i, count, componentIdx, statistics);
+        }
+#endif // ZIB_SIMD_X86
+
+        template <size_t Stride, bool ComputeRange>
+        void ConvertFloat16ToFloat32Scalar(float* dst, const uint16_t* src, size_t count, size_t componentIdx, ValueRange* range) noexcept
+        {
+            ConvertTail<Stride, ComputeRange>(dst, src, 0, count, componentIdx, range);
+        }
+    } // namespace Detail
+
+    // Best instruction set supported by CPU and OS, detected once per process.
+    inline InstructionSet GetInstructionSet() noexcept
+    {
+#if ZIB_SIMD_X86
+        static const InstructionSet instructionSet = Detail::IsAVX2Supported() ? InstructionSet::AVX2 : InstructionSet::SSE2;
+        return instructionSet;
+#else
+        return InstructionSet::Scalar;
+#endif
+    }
+
+    namespace Detail
+    {
+        template <size_t Stride, bool ComputeRange>
+        void ConvertFloat16ToFloat32(float* dst, const uint16_t* src, size_t count, size_t componentIdx, ValueRange* range) noexcept
+        {
+            static_assert(Stride > 0, "Stride must be positive");
+            switch (GetInstructionSet())
+            {
+#if ZIB_SIMD_X86
+            case InstructionSet::AVX2:
+                ConvertFloat16ToFloat32AVX2<Stride, ComputeRange>(dst, src, count, componentIdx, range);
+                break;
+            case InstructionSet::SSE2:
+                ConvertFloat16ToFloat32SSE2<Stride, ComputeRange>(dst, src, count, componentIdx, range);
+                break;
+#endif
+            default:
+                ConvertFloat16ToFloat32Scalar<Stride, ComputeRange>(dst, src, count, componentIdx, range);
+                break;
+            }
+        }
+    } // namespace Detail
+
+    // Copies every Stride-th float of src starting from componentIdx to consecutive floats of dst,
+    // and accumulates statistics of copied values in the same pass.
+    // Min and max are exact, sums are accumulated per vector lane, so they may differ from sequential sum in last bits.
+    template <size_t Stride>
+    void PackWithStatistics(float* dst, const float* src, size_t count, size_t componentIdx, BlockStatistics& statistics) noexcept
+    {
+        static_assert(Stride > 0, "Stride must be positive");
+        switch (GetInstructionSet())
+        {
+#if ZIB_SIMD_X86
+        case InstructionSet::AVX2:
+            Detail::PackWithStatisticsAVX2<Stride>(dst, src, count, componentIdx, &statistics);
+            break;
+        case InstructionSet::SSE2:
+            Detail::PackWithStatisticsSSE2<Stride>(dst, src, count, componentIdx, &statistics);
+            break;
+#endif
+        default:
+            Detail::PackWithStatisticsTail<Stride>(dst, src, 0, count, componentIdx, &statistics);
+            break;
+        }
+    }
+
+    // Converts count float16 values and writes them to every Stride-th float of dst, starting from componentIdx.
+    // Results are bit exact with Float16ToFloat32: denormals are flushed to zero, inf and NaN are propagated.
+    template <size_t Stride>
+    void ConvertFloat16ToFloat32(float* dst, const uint16_t* src, size_t count, size_t componentIdx = 0) noexcept
+    {
+        Detail::ConvertFloat16ToFloat32<Stride, false>(dst, src, count, componentIdx, nullptr);
+    }
+
+    // Same as ConvertFloat16ToFloat32, but also extends range with converted values in the same pass.
+    template <size_t Stride>
+    void ConvertFloat16ToFloat32(float* dst, const uint16_t* src, size_t count, size_t componentIdx, ValueRange& range) noexcept
+    {
+        Detail::ConvertFloat16ToFloat32<Stride, true>(dst, src, count, componentIdx, &range);
+    }
+} // namespace Zibra::CE::Addons::SIMDUtils
@@ -188,6 +188,7 @@ namespace Zibra::CE
         t1 += 0x38000000; // Adjust bias
 
         t1 = (t3 == 0 ? 0 : t1); // Denormals-as-zero
+        t1 = (t3 == 0x7c00u ? t1 + 0x38000000 : t1); // Inf/NaN keep largest exponent
 
         t1 |= t2; // Re-insert sign bit
 
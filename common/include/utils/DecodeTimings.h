@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <json.hpp>
+
+namespace Zibra::Helpers
+{
+    // Time spent in each stage of frame decoding.
+    // Chunk encoding runs on worker thread in parallel with readback, so sum of stages may exceed total time.
+    struct DecodeTimings
+    {
+        enum class Stage
+        {
+            RegisterDecompressor,
+            FetchFrame,
+            ParseGridShuffle,
+            SubmitDecompression,
+            Readback,
+            EncodeChunks,
+            // Part of EncodeChunks
+            ConstructGrids,
+            BuildPrimitives,
+            ApplyMetadata,
+            Total,
+            Count
+        };
+
+        using Clock = std::chrono::steady_clock;
+
+        std::array<Clock::duration, size_t(Stage::Count)> durations{};
+
+        void Add(Stage stage, Clock::duration duration) noexcept
+        {
+            durations[size_t(stage)] += duration;
+        }
+        void Add(const DecodeTimings& other) noexcept
+        {
+            for (size_t i = 0; i < durations.size(); ++i)
+            {
+                durations[i] += other.durations[i];
+            }
+        }
+        double GetMilliseconds(Stage stage) const noexcept
+        {
+            return std::chrono::duration<double, std::milli>(durations[size_t(stage)]).count();
+        }
+
+        static const char* GetStageName(Stage stage) noexcept;
+        // One line per stage, for node info panel.
+        std::string FormatText() const noexcept;
+        // Stage names mapped to milliseconds.
+        nlohmann::json ToJSON() const noexcept;
+    };
+
+    // Appends entry as single line to JSON lines file. Safe to call from multiple threads.
+    void AppendDecodeTimingsLog(const std::string& path, const nlohmann::json& entry) noexcept;
+
+    // Adds time elapsed between construction and destruction to the stage. Does nothing when timings is null.
+    class ScopedStageTimer
+    {
+    public:
+        ScopedStageTimer(DecodeTimings* timings, DecodeTimings::Stage stage) noexcept
+            : m_Timings(timings)
+            , m_Stage(stage)
+            , m_Start(DecodeTimings::Clock::now())
+        {
+        }
+        ~ScopedStageTimer() noexcept
+        {
+            if (m_Timings)
+            {
+                m_Timings->Add(m_Stage, DecodeTimings::Clock::now() - m_Start);
+            }
+        }
+
+        ScopedStageTimer(const ScopedStageTimer&) = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    private:
+        DecodeTimings* m_Timings;
+        DecodeTimings::Stage m_Stage;
+        DecodeTimings::Clock::time_point m_Start;
+    };
+} // namespace Zibra::Helpers
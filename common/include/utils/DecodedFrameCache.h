@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <UT/UT_Cache.h>
+#include <openvdb/openvdb.h>
+
+#include "FrameMetadataSnapshot.h"
+
+namespace Zibra::Helpers
+{
+    // Process wide LRU cache of decompressed frames, shared between all nodes that read the same sequence.
+    // Registered in Houdini Cache Manager, so its budget can be changed there and it is trimmed under memory pressure.
+    // Grids are returned as shallow copies which share trees with cached grids, so Houdini copy-on-write semantics apply.
+    // Transforms are not shared, each copy gets its own.
+    // Frame metadata is cached along with grids, so cache hit doesn't need to read the frame from file.
+    class DecodedFrameCache final : public UT_Cache
+    {
+    public:
+        struct Key
+        {
+            uint64_t fileUUID[2] = {};
+            int64_t frameIndex = 0;
+            // Sorted names of requested grids, so the same frame decompressed with different channel selections is cached separately.
+            std::string channelSet;
+            // Serialized region of interest, empty when whole frame is decompressed.
+            std::string region;
+            // Serialized options that change contents of decompressed grids, empty when defaults are used.
+            std::string gridOptions;
+
+            bool operator<(const Key& other) const noexcept
+            {
+                return std::tie(fileUUID[0], fileUUID[1], frameIndex, channelSet, region, gridOptions) <
+                       std::tie(other.fileUUID[0], other.fileUUID[1], other.frameIndex, other.channelSet, other.region, other.gridOptions);
+            }
+        };
+
+        // Singleton
+        static DecodedFrameCache& GetInstance() noexcept;
+
+        // On success outFrameMetadata receives copy of cached metadata, which caller must Release.
+        bool Find(const Key& key, openvdb::GridPtrVec* outGrids, FrameMetadataSnapshot** outFrameMetadata) noexcept;
+        void Insert(const Key& key, const openvdb::GridPtrVec& grids, const FrameMetadataSnapshot& frameMetadata) noexcept;
+
+        // UT_Cache interface
+        const char* utilGetCacheName() const final;
+        int64 utilGetCurrentSize() const final;
+        int64 utilReduceCache(int64 amount) final;
+        bool utilHasMax() const final;
+        int64 utilGetMax() const final;
+        void utilSetMax(int64 amount) final;
+
+    private:
+        struct Entry
+        {
+            Key key;
+            openvdb::GridPtrVec grids;
+            std::shared_ptr<FrameMetadataSnapshot> frameMetadata;
+            int64 sizeInBytes = 0;
+        };
+
+        DecodedFrameCache() noexcept;
+
+        static openvdb::GridPtrVec ShallowCopyGrids(const openvdb::GridPtrVec& grids) noexcept;
+        static int64 GetDefaultBudget() noexcept;
+        // Evicts least recently used entries until cache size is not larger than targetSize. Returns freed size.
+        int64 EvictUntil(int64 targetSize) noexcept;
+
+        mutable std::mutex m_Mutex;
+        // Most recently used entries are at the front
+        std::list<Entry> m_Entries;
+        std::map<Key, std::list<Entry>::iterator> m_EntriesByKey;
+        int64 m_CurrentSize = 0;
+        int64 m_Budget = 0;
+    };
+} // namespace Zibra::Helpers
@@ -1,12 +1,75 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
 #include <Zibra/CE/Decompression.h>
 #include <Zibra/CE/Addons/OpenVDBFrameEncoder.h>
 
+#include "DecodeTimings.h"
+#include "SpatialBlockIndex.h"
+
 namespace Zibra::Helpers
 {
     using namespace Zibra;
 
+    // Bounding box that limits decompressed part of a frame.
+    struct RegionOfInterest
+    {
+        enum class Space
+        {
+            // Bounding box is in world space, it is converted to index space of each decompressed channel
+            World,
+            // Bounding box is in index space of decompressed grids
+            Index
+        };
+
+        Space space = Space::World;
+        openvdb::BBoxd bbox;
+
+        bool operator==(const RegionOfInterest& other) const noexcept
+        {
+            return space == other.space && bbox == other.bbox;
+        }
+        bool operator!=(const RegionOfInterest& other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    // Options that limit amount of work done when decompressing a frame.
+    struct FrameDecodeOptions
+    {
+        // Names of grids to construct. Grid is also selected when name of any of its source channels is in the set.
+        // Empty set means all grids stored in file.
+        // Spatial blocks that don't have any channel used by selected grids are neither read back nor encoded.
+        std::set<std::string> gridNames;
+        // Spatial blocks that don't intersect region of interest are neither read back nor encoded.
+        // Leafs of decompressed grids are not clipped, so grids may extend past the region by up to one block.
+        std::optional<RegionOfInterest> regionOfInterest;
+        // Voxels within tolerance of background are deactivated, and leafs without active voxels are dropped.
+        bool deactivateBackground = false;
+        float backgroundTolerance = 0.0f;
+        // Uniform blocks are stored as tiles instead of leafs.
+        bool collapseUniformBlocks = false;
+        float uniformTolerance = 0.0f;
+        CE::Addons::OpenVDBUtils::GridPrecision precision = CE::Addons::OpenVDBUtils::GridPrecision::Float32;
+
+        bool operator==(const FrameDecodeOptions& other) const noexcept
+        {
+            return gridNames == other.gridNames && regionOfInterest == other.regionOfInterest &&
+                   deactivateBackground == other.deactivateBackground && backgroundTolerance == other.backgroundTolerance &&
+                   collapseUniformBlocks == other.collapseUniformBlocks && uniformTolerance == other.uniformTolerance &&
+                   precision == other.precision;
+        }
+        bool operator!=(const FrameDecodeOptions& other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
     class DecompressorManager
     {
         struct BufferDesc
@@ -16,14 +79,85 @@ namespace Zibra::Helpers
             size_t stride = 0;
         };
 
+        // Set of external buffers single chunk is decompressed into.
+        // Several slots allow GPU to decompress next chunks while previous one is being read back.
+        struct ReadbackSlot
+        {
+            BufferDesc perChannelBlockData;
+            BufferDesc perChannelBlockInfo;
+            BufferDesc perSpatialBlockInfo;
+            size_t firstSpatialBlockIndex = 0;
+            size_t spatialBlocksCount = 0;
+            CE::Decompression::DecompressedFrameFeedback feedback{};
+        };
+
+        // Range of spatial blocks decompressed by single submit.
+        struct SpatialBlockRange
+        {
+            size_t firstSpatialBlockIndex = 0;
+            size_t spatialBlocksCount = 0;
+        };
+
+        // Selects spatial blocks of read back chunk that need to be encoded.
+        struct SpatialBlockFilter
+        {
+            uint32_t requiredChannelMask = 0;
+            // Spatial blocks outside of these bounds are dropped. No culling by position when not set.
+            std::optional<BlockBounds> regionBounds;
+            // Index that was used to select chunks. Every read back spatial block must be within bounds of its group,
+            // otherwise index doesn't describe the frame and blocks of skipped groups may be missing.
+            const std::vector<BlockBounds>* indexedGroupBounds = nullptr;
+        };
+
+        static constexpr uint32_t READBACK_RING_SLOT_COUNT = 2;
+
+        // Host copy of single read back chunk, waiting to be encoded into OpenVDB grids.
+        struct HostChunkBuffer
+        {
+            std::vector<CE::Decompression::Shaders::PackedSpatialBlockInfo> perSpatialBlockInfo;
+            std::vector<uint16_t> perChannelBlockData;
+            size_t spatialBlocksCount = 0;
+            size_t firstChannelBlockIndex = 0;
+        };
+
+        // Max number of read back chunks waiting for encoding.
+        // One more host buffer is needed for the chunk that is currently being encoded.
+        static constexpr uint32_t ENCODE_QUEUE_DEPTH = 2;
+        static constexpr uint32_t HOST_CHUNK_BUFFER_COUNT = ENCODE_QUEUE_DEPTH + 1;
+
+        // Worker thread that encodes read back chunks, defined in DecompressorManager.cpp.
+        class ChunkEncodingPipeline;
+
+        // Skipped channel block ranges shorter than that are still read back, to avoid issuing too many small readbacks.
+        static constexpr size_t READBACK_MIN_SKIPPED_CHANNEL_BLOCKS = 64;
+
+        // Memory limit per resource is picked per frame from power of two buckets in this range,
+        // so frames of similar size share decompressor, and only few decompressors are created per leased file.
+        static constexpr size_t MIN_MEMORY_LIMIT_PER_RESOURCE = size_t(16) * 1024 * 1024;
+        static constexpr size_t MAX_AUTO_MEMORY_LIMIT_PER_RESOURCE = size_t(1024) * 1024 * 1024;
+        // Every readback slot and host chunk buffer holds up to memory limit worth of data,
+        // so automatic limit only takes small fraction of physical memory.
+        static constexpr uint64_t AUTO_MEMORY_LIMIT_PHYSICAL_MEMORY_DIVISOR = 64;
+
     public:
         ~DecompressorManager() noexcept;
         CE::ReturnCode Initialize() noexcept;
         CE::ReturnCode RegisterDecompressor(const UT_String& filename) noexcept;
+        // Upper bound of memory limit per decompressor resource in bytes. 0 means limit is selected automatically,
+        // either from ZIBRAVDB_FOR_HOUDINI_DECOMPRESSION_MEMORY_LIMIT_MB or from physical memory size.
+        // Applied starting from next fetched frame.
+        void SetMemoryLimitPerResource(size_t limitInBytes) noexcept;
         CE::ReturnCode DecompressFrame(CE::Decompression::CompressedFrameContainer* frameContainer,
-                                       std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> gridShuffle,
-                                       openvdb::GridPtrVec* vdbGrids) noexcept;
-        CE::Decompression::CompressedFrameContainer* FetchFrame(const exint& frameIndex) const noexcept;
+                                       std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> gridShuffle, openvdb::GridPtrVec* vdbGrids,
+                                       const FrameDecodeOptions& options = {}) noexcept;
+        // Takes frame from process wide DecodedFrameCache when available, without reading it from file.
+        // Otherwise fetches and decompresses the frame and stores it in the cache.
+        // outFrameMetadata receives snapshot of frame info and metadata, which caller must Release.
+        // Returns ZCE_ERROR_NOT_FOUND when frame can't be fetched. Empty frames succeed with no grids.
+        CE::ReturnCode DecompressFrameCached(exint frameIndex, const FrameDecodeOptions& options, openvdb::GridPtrVec* vdbGrids,
+                                             CE::Decompression::CompressedFrameContainer** outFrameMetadata) noexcept;
+        // Frame must be decompressed by the same manager, since it may switch decompressor to fit frame size.
+        CE::Decompression::CompressedFrameContainer* FetchFrame(const exint& frameIndex) noexcept;
         CE::Decompression::FrameRange GetFrameRange() const noexcept;
         void Release() noexcept;
         
@@ -32,28 +166,67 @@ namespace Zibra::Helpers
         
         CE::Decompression::SequenceInfo GetSequenceInfo() const noexcept;
 
+        // Timings of decoding stages accumulated since last ResetTimings call.
+        const DecodeTimings& GetTimings() const noexcept;
+        void ResetTimings() noexcept;
+
         const UT_String& GetWarning() const noexcept;
+        // Path of the file decoder was created for, after patching of the file extension.
+        // Empty if no decompressor is registered.
+        const UT_String& GetRegisteredFileName() const noexcept;
 
     private:
-        CE::ReturnCode GetDecompressedFrameData(uint16_t* perChannelBlockData, size_t channelBlocksCount,
-                                                CE::Decompression::Shaders::PackedSpatialBlockInfo* perSpatialBlockInfo,
-                                                size_t spatialBlocksCount) const noexcept;
+        // indexKey is used to look up and build SpatialBlockIndex of the frame, it is only known when frame index is known.
+        CE::ReturnCode DecompressFrameImpl(CE::Decompression::CompressedFrameContainer* frameContainer,
+                                           std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> gridShuffle, openvdb::GridPtrVec* vdbGrids,
+                                           const FrameDecodeOptions& options, const SpatialBlockIndex::Key* indexKey) noexcept;
+        CE::ReturnCode SubmitChunk(CE::Decompression::CompressedFrameContainer* frameContainer, size_t firstSpatialBlockIndex,
+                                   size_t spatialBlocksCount, ReadbackSlot& slot) noexcept;
+        // When groupBounds is not null, bounds of every read back spatial block are accumulated there, before filter is applied.
+        // isIndexMismatch is set when spatial block is outside of its group in filter.indexedGroupBounds.
+        CE::ReturnCode GetDecompressedFrameData(const ReadbackSlot& slot, const SpatialBlockFilter& filter, HostChunkBuffer& hostBuffer,
+                                                std::vector<BlockBounds>* groupBounds, bool* isIndexMismatch) const noexcept;
+        // Converts region of interest to bounds in packed block coordinates, that enclose region in space of every required channel.
+        static BlockBounds ComputeRegionBounds(const RegionOfInterest& regionOfInterest, const CE::Addons::OpenVDBUtils::FrameEncoder& encoder,
+                                               uint32_t requiredChannelMask,
+                                               const CE::Addons::OpenVDBUtils::EncodingMetadata* encodingMetadata) noexcept;
+        static void PrepareGridShuffle(const CE::Decompression::FrameInfo& frameInfo,
+                                       std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc>& gridShuffle,
+                                       const FrameDecodeOptions& options) noexcept;
+        CE::ReturnCode AllocateReadbackSlot(ReadbackSlot& slot) noexcept;
         CE::ReturnCode AllocateExternalBuffer(BufferDesc& bufferDesc, size_t newSizeInBytes, size_t newStride) noexcept;
+        CE::ReturnCode FreeExternalBuffer(BufferDesc& bufferDesc) noexcept;
         CE::ReturnCode FreeExternalBuffers() noexcept;
+        void ReleaseDecompressorLease() noexcept;
+        CE::ReturnCode AcquireDecompressorLease(const std::string& filename, size_t memoryLimitPerResource) noexcept;
+        // Keeps decoder of leased file, only decompressor and its format mapper are switched.
+        CE::ReturnCode SwitchDecompressorLease(size_t memoryLimitPerResource) noexcept;
+        size_t GetMaxMemoryLimitPerResource() const noexcept;
+        // Smallest bucket that fits whole frame in single submit, or max limit when frame doesn't fit.
+        size_t SelectMemoryLimitPerResource(const CE::Decompression::FrameInfo& frameInfo) const noexcept;
 
     private:
-        CE::Decompression::DecompressorFactory* m_DecompressorFactory = nullptr;
+        // Runtime, decoder, decompressor and format mapper are leased from DecompressorPool.
+        // Runtime is shared with other managers, the rest is used only by this manager until lease is released.
         CE::ZibraVDB::FileDecoder* m_Decoder = nullptr;
         CE::Decompression::Decompressor* m_Decompressor = nullptr;
         CE::Decompression::FormatMapper* m_FormatMapper = nullptr;
         RHI::RHIRuntime* m_RHIRuntime = nullptr;
         bool m_IsInitialized = false;
 
-        BufferDesc m_DecompressionPerChannelBlockDataBuffer;
-        BufferDesc m_DecompressionPerChannelBlockInfoBuffer;
-        BufferDesc m_DecompressionPerSpatialBlockInfoBuffer;
+        size_t m_MemoryLimitOverride = 0;
+        // Memory limit leased decompressor was created with
+        size_t m_MemoryLimitPerResource = 0;
+
+        CE::Decompression::DecompressorResourcesRequirements m_ResourcesRequirements{};
+        std::array<ReadbackSlot, READBACK_RING_SLOT_COUNT> m_ReadbackRing{};
+        std::array<HostChunkBuffer, HOST_CHUNK_BUFFER_COUNT> m_HostChunkBuffers{};
+        // Started on first decompressed frame and stopped on Release.
+        std::unique_ptr<ChunkEncodingPipeline> m_EncodingPipeline;
 
         UT_String m_Warning;
+        UT_String m_RegisteredFileName;
+        DecodeTimings m_Timings;
 
         UT_String GetPatchedFileName(const UT_String& filename) const noexcept;
     };
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <Zibra/CE/Decompression.h>
+#include <Zibra/RHI.h>
+
+namespace Zibra::Helpers
+{
+    using namespace Zibra;
+
+    // Process wide pool of decompression objects, shared between all DecompressorManager instances.
+    // Owns single RHI runtime, leases decompressors per file and recycles external GPU buffers,
+    // so device memory and initialization cost don't scale with number of nodes.
+    // Objects that are not leased anymore are kept alive for IDLE_RECLAIM_TIMEOUT, so reopening same file is cheap.
+    // Idle objects are reclaimed by background thread as well, so memory is freed even when no node cooks anymore.
+    class DecompressorPool
+    {
+    public:
+        struct DecompressorLease
+        {
+            CE::ZibraVDB::FileDecoder* decoder = nullptr;
+            CE::Decompression::Decompressor* decompressor = nullptr;
+            CE::Decompression::FormatMapper* formatMapper = nullptr;
+        };
+
+        static constexpr std::chrono::seconds IDLE_RECLAIM_TIMEOUT{30};
+        static constexpr std::chrono::seconds IDLE_RECLAIM_INTERVAL{10};
+
+        // Singleton
+        static DecompressorPool& GetInstance() noexcept;
+
+        // Every successful AcquireRuntime call must be paired with ReleaseRuntime.
+        // When last reference is released all pooled objects are freed.
+        CE::ReturnCode AcquireRuntime(RHI::RHIRuntime** outRuntime) noexcept;
+        void ReleaseRuntime() noexcept;
+
+        // Decoder, decompressor and format mapper of a lease are used by single caller until it's released,
+        // since format mapper and frame containers it allocates are not safe to use from several threads.
+        // Several callers that open same file get separate leases.
+        CE::ReturnCode AcquireDecompressor(const std::string& filename, size_t memoryLimitPerResource, DecompressorLease* outLease) noexcept;
+        // Switches lease to decompressor with another memory limit, that shares decoder with the leased one,
+        // so file is not opened and parsed again. Decompressors created for other limits are kept until lease is released,
+        // so frame containers they allocated stay valid and switching back and forth doesn't recreate them.
+        // Previous lease is still valid when switch fails.
+        CE::ReturnCode SwitchDecompressor(const DecompressorLease& lease, size_t memoryLimitPerResource,
+                                          DecompressorLease* outLease) noexcept;
+        void ReleaseDecompressor(const DecompressorLease& lease) noexcept;
+
+        CE::ReturnCode AcquireBuffer(size_t sizeInBytes, size_t stride, RHI::Buffer** outBuffer) noexcept;
+        void ReleaseBuffer(RHI::Buffer* buffer) noexcept;
+
+        // Shared runtime is not thread safe.
+        // Must be held for the whole sequence of GPU work that relies on decompressor state, e.g. registered resources,
+        // but not across CPU work, since it blocks every other manager sharing the runtime.
+        // Pool methods that create or free pooled objects lock it as well.
+        std::recursive_mutex& GetDeviceMutex() noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // File size and modification time are part of the key, so file overwritten on disk is not served by stale decoder.
+        struct FileKey
+        {
+            std::string filename;
+            uintmax_t fileSize = 0;
+            std::filesystem::file_time_type lastWriteTime{};
+
+            bool operator<(const FileKey& other) const noexcept
+            {
+                return std::tie(filename, fileSize, lastWriteTime) < std::tie(other.filename, other.fileSize, other.lastWriteTime);
+            }
+        };
+
+        // Decoder opened for a file and decompressors created with it, one per memory limit.
+        // Format mapper can't be shared between decompressors, since frame container can only be decompressed
+        // by decompressor whose format mapper fetched it.
+        struct FileEntry
+        {
+            CE::ZibraVDB::FileDecoder* decoder = nullptr;
+            std::map<size_t, DecompressorLease> decompressors;
+            bool isLeased = false;
+            Clock::time_point lastReleaseTime{};
+        };
+
+        struct BufferKey
+        {
+            size_t sizeInBytes = 0;
+            size_t stride = 0;
+
+            bool operator<(const BufferKey& other) const noexcept
+            {
+                return std::tie(sizeInBytes, stride) < std::tie(other.sizeInBytes, other.stride);
+            }
+        };
+
+        struct IdleBuffer
+        {
+            RHI::Buffer* buffer = nullptr;
+            Clock::time_point lastReleaseTime{};
+        };
+
+        DecompressorPool() noexcept = default;
+        // Pooled objects are intentionally not released on static destruction since ZibraVDB library may be already unloaded.
+        // Only reclaim thread is stopped.
+        ~DecompressorPool() noexcept;
+
+        CE::ReturnCode InitializeRuntime() noexcept;
+        CE::ReturnCode GetOrCreateDecompressor(FileEntry& entry, size_t memoryLimitPerResource, DecompressorLease* outLease) noexcept;
+        FileEntry* FindLeasedEntry(const DecompressorLease& lease) noexcept;
+        void ReclaimIdleObjects(bool forceAll) noexcept;
+        // Reclaim thread runs while runtime is acquired. It is also stopped on Houdini exit, before library is unloaded.
+        void StartReclaimThread() noexcept;
+        // Returned thread must be joined without holding pool locks, since reclaim thread takes them.
+        std::thread TakeReclaimThread() noexcept;
+        void StopReclaimThread() noexcept;
+        void ReclaimThreadLoop(size_t generation) noexcept;
+        static void ReleaseFileEntry(FileEntry& entry) noexcept;
+
+        // Lock order is m_DeviceMutex, then m_Mutex. m_Mutex only guards pool bookkeeping.
+        // Acquire methods and ReleaseRuntime lock device as well, since they create and reclaim pooled objects through runtime.
+        // ReleaseDecompressor and ReleaseBuffer only update bookkeeping, so they never wait for GPU work of other managers.
+        std::recursive_mutex m_DeviceMutex;
+        std::recursive_mutex m_Mutex;
+
+        RHI::RHIRuntime* m_RHIRuntime = nullptr;
+        CE::Decompression::DecompressorFactory* m_DecompressorFactory = nullptr;
+        size_t m_RuntimeRefCount = 0;
+
+        std::multimap<FileKey, FileEntry> m_Files;
+        std::map<RHI::Buffer*, BufferKey> m_LeasedBuffers;
+        std::multimap<BufferKey, IdleBuffer> m_IdleBuffers;
+
+        // Guards reclaim thread handle and generation. Reclaim thread exits once generation it was started with changes.
+        std::mutex m_ReclaimMutex;
+        std::condition_variable m_ReclaimWakeup;
+        std::thread m_ReclaimThread;
+        size_t m_ReclaimGeneration = 0;
+        bool m_IsExitCallbackRegistered = false;
+    };
+} // namespace Zibra::Helpers
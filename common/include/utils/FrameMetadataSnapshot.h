@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <Zibra/CE/Decompression.h>
+
+namespace Zibra::Helpers
+{
+    using namespace Zibra;
+
+    // Frame info and metadata copied out of frame container allocated by format mapper.
+    // Unlike original container it doesn't depend on format mapper, so it can outlive decompressor that fetched the frame
+    // and be handed to other threads. Same as original container, it's freed by Release.
+    class FrameMetadataSnapshot final : public CE::Decompression::CompressedFrameContainer
+    {
+    public:
+        static FrameMetadataSnapshot* Create(const CE::Decompression::CompressedFrameContainer* frameContainer) noexcept;
+
+        // Allocates independent copy of the snapshot.
+        FrameMetadataSnapshot* Clone() const noexcept;
+
+        CE::Decompression::FrameInfo GetInfo() const noexcept final;
+        const char* GetMetadataByKey(const char* key) const noexcept final;
+        size_t GetMetadataCount() const noexcept final;
+        CE::ReturnCode GetMetadataByIndex(size_t index, CE::MetadataEntry* outEntry) const noexcept final;
+        void Release() noexcept final;
+
+    private:
+        FrameMetadataSnapshot() noexcept = default;
+        FrameMetadataSnapshot(const FrameMetadataSnapshot& other) noexcept;
+        ~FrameMetadataSnapshot() noexcept override = default;
+
+        // Channel names of m_Info point into m_ChannelNames.
+        void BindChannelNames() noexcept;
+
+        CE::Decompression::FrameInfo m_Info{};
+        std::vector<std::string> m_ChannelNames;
+        std::vector<std::pair<std::string, std::string>> m_Metadata;
+    };
+} // namespace Zibra::Helpers
@@ -22,6 +22,15 @@ namespace Zibra::Helpers
     // Querying options set via environment variables
     Zibra::RHI::GFXAPI SelectGFXAPI();
     bool NeedForceSoftwareDevice();
+    bool NeedSerialDecompression();
+    // Memory limit per decompressor resource in bytes, 0 when it is not set
+    size_t GetDecompressionMemoryLimitOverride();
+    // Path of JSON lines file decode timings are appended to, not set when logging is disabled
+    std::optional<std::string> GetDecodeTimingsLogPath();
+
+    // System information
+    // Physical memory size in bytes, 0 when it can't be queried
+    uint64_t GetPhysicalMemorySize();
 
     // Path parsing
     std::string GetExtension(const std::string& filePath);
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <Zibra/CE/Common.h>
+
+namespace Zibra::Helpers
+{
+    // Inclusive bounds of spatial blocks in packed block coordinates, i.e. without decode offset applied.
+    struct BlockBounds
+    {
+        int32_t min[3] = {INT32_MAX, INT32_MAX, INT32_MAX};
+        int32_t max[3] = {INT32_MIN, INT32_MIN, INT32_MIN};
+
+        bool IsEmpty() const noexcept
+        {
+            return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+        }
+        bool Contains(const int32_t coords[3]) const noexcept
+        {
+            return coords[0] >= min[0] && coords[0] <= max[0] && coords[1] >= min[1] && coords[1] <= max[1] && coords[2] >= min[2] &&
+                   coords[2] <= max[2];
+        }
+        bool Intersects(const BlockBounds& other) const noexcept
+        {
+            return min[0] <= other.max[0] && max[0] >= other.min[0] && min[1] <= other.max[1] && max[1] >= other.min[1] &&
+                   min[2] <= other.max[2] && max[2] >= other.min[2];
+        }
+        void Extend(const int32_t coords[3]) noexcept
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                min[i] = std::min(min[i], coords[i]);
+                max[i] = std::max(max[i], coords[i]);
+            }
+        }
+    };
+
+    // Process wide index of frames, that stores bounds of every group of GROUP_SIZE consecutive spatial blocks.
+    // Compressor stores index of every frame in frame metadata, and it's loaded when frame is fetched, before any decompression.
+    // Spatial block coordinates of files compressed without index are only known after GPU decompression,
+    // so for them index is built as a side product of full frame decompression.
+    // Region of interest decompression of indexed frame then only submits groups that intersect the region,
+    // and culling costs one bounds check per group instead of one per spatial block.
+    class SpatialBlockIndex
+    {
+    public:
+        static constexpr uint32_t GROUP_SIZE = 1024;
+        // Index of single frame is small, so only number of frames is limited.
+        static constexpr size_t MAX_INDEXED_FRAMES = 4096;
+        static constexpr const char* METADATA_KEY = "houdiniSpatialBlockIndex";
+
+        struct Key
+        {
+            uint64_t fileUUID[2] = {};
+            int64_t frameIndex = 0;
+
+            bool operator<(const Key& other) const noexcept
+            {
+                return std::tie(fileUUID[0], fileUUID[1], frameIndex) < std::tie(other.fileUUID[0], other.fileUUID[1], other.frameIndex);
+            }
+        };
+
+        // Singleton
+        static SpatialBlockIndex& GetInstance() noexcept;
+
+        bool Find(const Key& key, std::vector<BlockBounds>* outGroupBounds) const noexcept;
+        bool Contains(const Key& key) const noexcept;
+        void Insert(const Key& key, std::vector<BlockBounds> groupBounds) noexcept;
+        void Erase(const Key& key) noexcept;
+
+        // Bounds of spatial blocks in order they are passed to compressor, which is the order they are decompressed in.
+        static std::vector<BlockBounds> BuildGroupBounds(const CE::SpatialBlockInfo* spatialInfo, size_t spatialInfoCount) noexcept;
+        static std::string Serialize(const std::vector<BlockBounds>& groupBounds, size_t spatialBlockCount) noexcept;
+        // Fails when index was stored with different group size or for different number of spatial blocks.
+        static bool Deserialize(const char* serialized, size_t spatialBlockCount, std::vector<BlockBounds>* outGroupBounds) noexcept;
+
+    private:
+        SpatialBlockIndex() noexcept = default;
+
+        mutable std::mutex m_Mutex;
+        std::map<Key, std::vector<BlockBounds>> m_GroupBoundsByKey;
+        // Oldest frames are evicted first
+        std::deque<Key> m_InsertionOrder;
+    };
+} // namespace Zibra::Helpers
@@ -2,15 +2,23 @@
 
 // Standard library
 #include <algorithm>
+#include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <optional>
 #include <regex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -40,6 +48,7 @@
 #include <UI/UI_Value.h>
 #include <UT/UT_EnvControl.h>
 #include <UT/UT_Error.h>
+#include <UT/UT_Exit.h>
 #include <UT/UT_IStream.h>
 #include <UT/UT_JSONHandle.h>
 #include <UT/UT_JSONParser.h>
@@ -83,9 +92,11 @@
 #elif ZIB_TARGET_OS_LINUX
 #include <curl/curl.h>
 #include <dlfcn.h>
+#include <unistd.h>
 #elif ZIB_TARGET_OS_MAC
 #include <curl/curl.h>
 #include <dlfcn.h>
+#include <sys/sysctl.h>
 #include <sys/xattr.h>
 #else
 #error Unexpected OS
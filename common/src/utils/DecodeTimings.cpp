@@ -0,0 +1,72 @@
+#include "PrecompiledHeader.h"
+
+#include "utils/DecodeTimings.h"
+
+namespace Zibra::Helpers
+{
+    const char* DecodeTimings::GetStageName(Stage stage) noexcept
+    {
+        switch (stage)
+        {
+        case Stage::RegisterDecompressor:
+            return "register_decompressor";
+        case Stage::FetchFrame:
+            return "fetch_frame";
+        case Stage::ParseGridShuffle:
+            return "parse_grid_shuffle";
+        case Stage::SubmitDecompression:
+            return "submit_decompression";
+        case Stage::Readback:
+            return "readback";
+        case Stage::EncodeChunks:
+            return "encode_chunks";
+        case Stage::ConstructGrids:
+            return "construct_grids";
+        case Stage::BuildPrimitives:
+            return "build_primitives";
+        case Stage::ApplyMetadata:
+            return "apply_metadata";
+        case Stage::Total:
+            return "total";
+        default:
+            assert(0);
+            return "unknown";
+        }
+    }
+
+    std::string DecodeTimings::FormatText() const noexcept
+    {
+        std::ostringstream result;
+        result << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < size_t(Stage::Count); ++i)
+        {
+            const Stage stage = static_cast<Stage>(i);
+            result << GetStageName(stage) << ": " << GetMilliseconds(stage) << " ms\n";
+        }
+        return result.str();
+    }
+
+    nlohmann::json DecodeTimings::ToJSON() const noexcept
+    {
+        nlohmann::json result = nlohmann::json::object();
+        for (size_t i = 0; i < size_t(Stage::Count); ++i)
+        {
+            const Stage stage = static_cast<Stage>(i);
+            result[GetStageName(stage)] = GetMilliseconds(stage);
+        }
+        return result;
+    }
+
+    void AppendDecodeTimingsLog(const std::string& path, const nlohmann::json& entry) noexcept
+    {
+        static std::mutex logMutex;
+        std::lock_guard lock(logMutex);
+
+        std::ofstream logFile(path, std::ios::app);
+        if (!logFile)
+        {
+            return;
+        }
+        logFile << entry.dump() << '\n';
+    }
+} // namespace Zibra::Helpers
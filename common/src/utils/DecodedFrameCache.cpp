@@ -0,0 +1,146 @@
+#include "PrecompiledHeader.h"
+
+#include "utils/DecodedFrameCache.h"
+
+#include "utils/Helpers.h"
+
+namespace Zibra::Helpers
+{
+    DecodedFrameCache& DecodedFrameCache::GetInstance() noexcept
+    {
+        static DecodedFrameCache instance;
+        return instance;
+    }
+
+    DecodedFrameCache::DecodedFrameCache() noexcept
+        : m_Budget(GetDefaultBudget())
+    {
+    }
+
+    bool DecodedFrameCache::Find(const Key& key, openvdb::GridPtrVec* outGrids, FrameMetadataSnapshot** outFrameMetadata) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        auto keyIt = m_EntriesByKey.find(key);
+        if (keyIt == m_EntriesByKey.end())
+        {
+            return false;
+        }
+
+        m_Entries.splice(m_Entries.begin(), m_Entries, keyIt->second);
+        *outGrids = ShallowCopyGrids(keyIt->second->grids);
+        *outFrameMetadata = keyIt->second->frameMetadata->Clone();
+        return true;
+    }
+
+    void DecodedFrameCache::Insert(const Key& key, const openvdb::GridPtrVec& grids, const FrameMetadataSnapshot& frameMetadata) noexcept
+    {
+        int64 sizeInBytes = 0;
+        for (const openvdb::GridBase::Ptr& grid : grids)
+        {
+            if (grid)
+            {
+                sizeInBytes += static_cast<int64>(grid->memUsage());
+            }
+        }
+
+        std::lock_guard lock(m_Mutex);
+
+        if (sizeInBytes > m_Budget || m_EntriesByKey.find(key) != m_EntriesByKey.end())
+        {
+            return;
+        }
+
+        EvictUntil(m_Budget - sizeInBytes);
+
+        Entry entry{};
+        entry.key = key;
+        entry.grids = ShallowCopyGrids(grids);
+        entry.frameMetadata.reset(frameMetadata.Clone(), [](FrameMetadataSnapshot* snapshot) { snapshot->Release(); });
+        entry.sizeInBytes = sizeInBytes;
+        m_Entries.push_front(std::move(entry));
+        m_EntriesByKey.emplace(key, m_Entries.begin());
+        m_CurrentSize += sizeInBytes;
+    }
+
+    const char* DecodedFrameCache::utilGetCacheName() const
+    {
+        return "ZibraVDB Decompressed Frames";
+    }
+
+    int64 DecodedFrameCache::utilGetCurrentSize() const
+    {
+        std::lock_guard lock(m_Mutex);
+        return m_CurrentSize;
+    }
+
+    int64 DecodedFrameCache::utilReduceCache(int64 amount)
+    {
+        std::lock_guard lock(m_Mutex);
+        return EvictUntil(m_CurrentSize - amount);
+    }
+
+    bool DecodedFrameCache::utilHasMax() const
+    {
+        return true;
+    }
+
+    int64 DecodedFrameCache::utilGetMax() const
+    {
+        std::lock_guard lock(m_Mutex);
+        return m_Budget;
+    }
+
+    void DecodedFrameCache::utilSetMax(int64 amount)
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Budget = std::max<int64>(amount, 0);
+        EvictUntil(m_Budget);
+    }
+
+    openvdb::GridPtrVec DecodedFrameCache::ShallowCopyGrids(const openvdb::GridPtrVec& grids) noexcept
+    {
+        openvdb::GridPtrVec result;
+        result.reserve(grids.size());
+        for (const openvdb::GridBase::Ptr& grid : grids)
+        {
+            if (!grid)
+            {
+                result.push_back(nullptr);
+                continue;
+            }
+            // copyGrid shares both tree and transform. Tree is protected by Houdini copy-on-write,
+            // but transform may be edited in place, so every copy gets its own.
+            openvdb::GridBase::Ptr copy = grid->copyGrid();
+            copy->setTransform(grid->constTransform().copy());
+            result.push_back(std::move(copy));
+        }
+        return result;
+    }
+
+    int64 DecodedFrameCache::GetDefaultBudget() noexcept
+    {
+        int budgetMB = ZIB_DECODED_FRAME_CACHE_SIZE_MB_DEFAULT;
+        std::optional<std::string> envVar = GetNormalEnvironmentVariable("ZIBRAVDB_FOR_HOUDINI_DECODED_FRAME_CACHE_SIZE_MB");
+        int envBudgetMB = 0;
+        if (envVar.has_value() && TryParseInt(envVar.value(), envBudgetMB) && envBudgetMB >= 0)
+        {
+            budgetMB = envBudgetMB;
+        }
+        return static_cast<int64>(budgetMB) * 1024 * 1024;
+    }
+
+    int64 DecodedFrameCache::EvictUntil(int64 targetSize) noexcept
+    {
+        int64 freedSize = 0;
+        while (!m_Entries.empty() && m_CurrentSize > targetSize)
+        {
+            const Entry& entry = m_Entries.back();
+            m_CurrentSize -= entry.sizeInBytes;
+            freedSize += entry.sizeInBytes;
+            m_EntriesByKey.erase(entry.key);
+            m_Entries.pop_back();
+        }
+        return freedSize;
+    }
+} // namespace Zibra::Helpers
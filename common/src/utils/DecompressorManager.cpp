@@ -3,78 +3,167 @@
 #include "utils/DecompressorManager.h"
 
 #include "bridge/LibraryUtils.h"
+#include "utils/DecodedFrameCache.h"
+#include "utils/DecompressorPool.h"
+#include "utils/FrameMetadataSnapshot.h"
 #include "utils/Helpers.h"
 
 namespace Zibra::Helpers
 {
-    DecompressorManager::~DecompressorManager() noexcept
+    // Encodes read back chunks on worker thread, so CPU encoding of previous chunks overlaps with GPU decompression
+    // and readback of the next ones. Chunks are encoded in submission order by single consumer.
+    // Host buffers are handed back to the producer after encoding, which bounds memory used by in-flight chunks.
+    // Worker thread lives as long as the manager, so it is not started again for every frame.
+    class DecompressorManager::ChunkEncodingPipeline
     {
-        Release();
-    }
+    public:
+        ChunkEncodingPipeline(HostChunkBuffer* hostBuffers, size_t hostBuffersCount, DecodeTimings* timings) noexcept
+            : m_HostBuffers(hostBuffers)
+            , m_HostBuffersCount(hostBuffersCount)
+            , m_Timings(timings)
+        {
+            ResetFreeBuffers();
+            m_Worker = std::thread(&ChunkEncodingPipeline::WorkerLoop, this);
+        }
 
-    CE::ReturnCode DecompressorManager::Initialize() noexcept
-    {
-        if (m_IsInitialized)
+        ~ChunkEncodingPipeline() noexcept
         {
-            return CE::ZCE_SUCCESS;
+            {
+                std::lock_guard lock(m_Mutex);
+                m_IsStopping = true;
+            }
+            m_ChunkSubmitted.notify_one();
+            m_Worker.join();
         }
 
-        if (!Zibra::LibraryUtils::TryLoadLibrary())
+        // Encoder and metadata must stay alive until Finish returns.
+        void Begin(CE::Addons::OpenVDBUtils::FrameEncoder& encoder,
+                   const CE::Addons::OpenVDBUtils::EncodingMetadata* encodingMetadata) noexcept
         {
-            return CE::ZCE_ERROR;
+            std::lock_guard lock(m_Mutex);
+            m_Encoder = &encoder;
+            m_EncodingMetadata = encodingMetadata;
         }
 
-        RHI::RHIFactory* RHIFactory = nullptr;
-        auto RHIstatus = RHI::CAPI::CreateRHIFactory(&RHIFactory);
-        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        HostChunkBuffer* AcquireBuffer() noexcept
         {
-            return CE::ZCE_ERROR;
+            std::unique_lock lock(m_Mutex);
+            m_BufferReleased.wait(lock, [this] { return !m_FreeBuffers.empty(); });
+            HostChunkBuffer* hostBuffer = m_FreeBuffers.front();
+            m_FreeBuffers.pop_front();
+            return hostBuffer;
         }
 
-        RHIstatus = RHIFactory->SetGFXAPI(Helpers::SelectGFXAPI());
-        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        void Submit(HostChunkBuffer* hostBuffer) noexcept
         {
-            return CE::ZCE_ERROR;
+            {
+                std::lock_guard lock(m_Mutex);
+                m_PendingBuffers.push_back(hostBuffer);
+                ++m_InFlightCount;
+            }
+            m_ChunkSubmitted.notify_one();
         }
 
-        if (Helpers::NeedForceSoftwareDevice())
+        // Waits until all submitted chunks are encoded. Worker thread keeps running for the next frame.
+        void Finish() noexcept
+        {
+            std::unique_lock lock(m_Mutex);
+            m_BufferReleased.wait(lock, [this] { return m_InFlightCount == 0; });
+            m_Encoder = nullptr;
+            m_EncodingMetadata = nullptr;
+            // Buffers acquired but not submitted before failure are returned here too.
+            ResetFreeBuffers();
+        }
+
+    private:
+        void ResetFreeBuffers() noexcept
         {
-            RHIstatus = RHIFactory->ForceSoftwareDevice();
-            if (RHIstatus != RHI::ZRHI_SUCCESS)
+            m_FreeBuffers.clear();
+            for (size_t i = 0; i < m_HostBuffersCount; ++i)
             {
-                return CE::ZCE_ERROR;
+                m_FreeBuffers.push_back(&m_HostBuffers[i]);
             }
         }
 
-        RHIstatus = RHIFactory->Create(&m_RHIRuntime);
-        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        void WorkerLoop() noexcept
         {
-            return CE::ZCE_ERROR;
+            while (true)
+            {
+                HostChunkBuffer* hostBuffer = nullptr;
+                CE::Addons::OpenVDBUtils::FrameEncoder* encoder = nullptr;
+                const CE::Addons::OpenVDBUtils::EncodingMetadata* encodingMetadata = nullptr;
+                {
+                    std::unique_lock lock(m_Mutex);
+                    m_ChunkSubmitted.wait(lock, [this] { return !m_PendingBuffers.empty() || m_IsStopping; });
+                    if (m_PendingBuffers.empty())
+                    {
+                        return;
+                    }
+                    hostBuffer = m_PendingBuffers.front();
+                    m_PendingBuffers.pop_front();
+                    encoder = m_Encoder;
+                    encodingMetadata = m_EncodingMetadata;
+                }
+
+                {
+                    // Only encoding stage is written by worker thread, producer writes other stages.
+                    ScopedStageTimer timer(m_Timings, DecodeTimings::Stage::EncodeChunks);
+                    CE::Addons::OpenVDBUtils::FrameData fData{};
+                    fData.decompressionPerChannelBlockData = hostBuffer->perChannelBlockData.data();
+                    fData.decompressionPerSpatialBlockInfo = hostBuffer->perSpatialBlockInfo.data();
+                    encoder->EncodeChunk(fData, hostBuffer->spatialBlocksCount, hostBuffer->firstChannelBlockIndex, encodingMetadata);
+                }
+
+                {
+                    std::lock_guard lock(m_Mutex);
+                    m_FreeBuffers.push_back(hostBuffer);
+                    --m_InFlightCount;
+                }
+                // Both producer waiting for buffer and Finish wait on this, so all waiters are woken
+                m_BufferReleased.notify_all();
+            }
         }
-        RHIFactory->Release();
 
-        RHIstatus = m_RHIRuntime->Initialize();
-        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        HostChunkBuffer* m_HostBuffers = nullptr;
+        size_t m_HostBuffersCount = 0;
+        DecodeTimings* m_Timings = nullptr;
+        CE::Addons::OpenVDBUtils::FrameEncoder* m_Encoder = nullptr;
+        const CE::Addons::OpenVDBUtils::EncodingMetadata* m_EncodingMetadata = nullptr;
+        std::mutex m_Mutex;
+        std::condition_variable m_ChunkSubmitted;
+        std::condition_variable m_BufferReleased;
+        std::deque<HostChunkBuffer*> m_FreeBuffers;
+        std::deque<HostChunkBuffer*> m_PendingBuffers;
+        size_t m_InFlightCount = 0;
+        bool m_IsStopping = false;
+        std::thread m_Worker;
+    };
+
+    DecompressorManager::~DecompressorManager() noexcept
+    {
+        // Owners may outlive the library, e.g. nodes destroyed on Houdini exit, and then nothing can be released.
+        if (!Zibra::LibraryUtils::IsLibraryLoaded())
         {
-            m_RHIRuntime->Release();
-            m_RHIRuntime = nullptr;
-            return CE::ZCE_ERROR;
+            return;
         }
+        Release();
+    }
 
-        auto status = CE::Decompression::CAPI::CreateDecompressorFactory(&m_DecompressorFactory);
-        if (status != CE::ZCE_SUCCESS)
+    CE::ReturnCode DecompressorManager::Initialize() noexcept
+    {
+        if (m_IsInitialized)
         {
-            return status;
+            return CE::ZCE_SUCCESS;
         }
 
-        using namespace Zibra::CE::Literals::Memory;
-        m_DecompressorFactory->SetMemoryLimitPerResource(128_MiB);
+        if (!Zibra::LibraryUtils::TryLoadLibrary())
+        {
+            return CE::ZCE_ERROR;
+        }
 
-        status = m_DecompressorFactory->UseRHI(m_RHIRuntime);
+        auto status = DecompressorPool::GetInstance().AcquireRuntime(&m_RHIRuntime);
         if (status != CE::ZCE_SUCCESS)
         {
-            m_DecompressorFactory->Release();
-            m_DecompressorFactory = nullptr;
             return status;
         }
 
@@ -87,14 +176,10 @@ namespace Zibra::Helpers
     {
         if (bufferDesc.sizeInBytes != newSizeInBytes || bufferDesc.stride != newStride)
         {
-            if (bufferDesc.buffer)
+            auto status = FreeExternalBuffer(bufferDesc);
+            if (status != CE::ZCE_SUCCESS)
             {
-                auto RHIstatus = m_RHIRuntime->ReleaseBuffer(bufferDesc.buffer);
-                if (RHIstatus != RHI::ZRHI_SUCCESS)
-                {
-                    return CE::ZCE_ERROR;
-                }
-                bufferDesc.buffer = nullptr;
+                return status;
             }
 
             // Do not create empty buffer
@@ -103,13 +188,10 @@ namespace Zibra::Helpers
                 return CE::ZCE_SUCCESS;
             }
 
-            auto RHIstatus = m_RHIRuntime->CreateBuffer(
-                newSizeInBytes, RHI::ResourceHeapType::Default,
-                RHI::ResourceUsage::UnorderedAccess | RHI::ResourceUsage::ShaderResource | RHI::ResourceUsage::CopySource,
-                static_cast<uint32_t>(newStride), "decompressionPerChannelBlockData", &bufferDesc.buffer);
-            if (RHIstatus != RHI::ZRHI_SUCCESS)
+            status = DecompressorPool::GetInstance().AcquireBuffer(newSizeInBytes, newStride, &bufferDesc.buffer);
+            if (status != CE::ZCE_SUCCESS)
             {
-                return CE::ZCE_ERROR;
+                return status;
             }
             bufferDesc.sizeInBytes = newSizeInBytes;
             bufferDesc.stride = newStride;
@@ -117,15 +199,34 @@ namespace Zibra::Helpers
         return CE::ZCE_SUCCESS;
     }
 
+    CE::ReturnCode DecompressorManager::AllocateReadbackSlot(ReadbackSlot& slot) noexcept
+    {
+        auto status = AllocateExternalBuffer(slot.perChannelBlockData, m_ResourcesRequirements.decompressionPerChannelBlockDataSizeInBytes,
+                                             m_ResourcesRequirements.decompressionPerChannelBlockDataStride);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            return status;
+        }
+        status = AllocateExternalBuffer(slot.perChannelBlockInfo, m_ResourcesRequirements.decompressionPerChannelBlockInfoSizeInBytes,
+                                        m_ResourcesRequirements.decompressionPerChannelBlockInfoStride);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            return status;
+        }
+        return AllocateExternalBuffer(slot.perSpatialBlockInfo, m_ResourcesRequirements.decompressionPerSpatialBlockInfoSizeInBytes,
+                                      m_ResourcesRequirements.decompressionPerSpatialBlockInfoStride);
+    }
+
     CE::ReturnCode DecompressorManager::RegisterDecompressor(const UT_String& filename) noexcept
     {
+        ScopedStageTimer timer(&m_Timings, DecodeTimings::Stage::RegisterDecompressor);
+
         m_Warning = "";
+        m_RegisteredFileName = "";
 
-        if (m_Decoder)
-        {
-            CE::Decompression::CAPI::ReleaseDecoder(m_Decoder);
-            m_Decoder = nullptr;
-        }
+        std::lock_guard deviceLock(DecompressorPool::GetInstance().GetDeviceMutex());
+
+        ReleaseDecompressorLease();
 
         UT_String patchedFileName = GetPatchedFileName(filename);
         if (patchedFileName.length() == 0)
@@ -133,130 +234,159 @@ namespace Zibra::Helpers
             return CE::ZCE_ERROR_NOT_FOUND;
         }
 
-        auto status = CE::Decompression::CAPI::CreateDecoder(patchedFileName.c_str(), &m_Decoder);
+        // Frame size is not known yet, so decompressor is created with max limit and is switched once first frame is fetched.
+        auto status = AcquireDecompressorLease(patchedFileName.toStdString(), GetMaxMemoryLimitPerResource());
         if (status != CE::ZCE_SUCCESS)
         {
             return status;
         }
 
-        if (!m_DecompressorFactory)
-        {
-            return CE::ZCE_ERROR;
-        }
+        std::string filenameStdStr = patchedFileName.toStdString();
+        std::string actualFileExtension = Helpers::GetExtension(filenameStdStr);
+        std::string expectedFileExtension = m_FormatMapper->GetExpectedFileExtension();
 
-        status = m_DecompressorFactory->UseDecoder(m_Decoder);
-        if (status != CE::ZCE_SUCCESS)
+        if (actualFileExtension != expectedFileExtension)
         {
-            return status;
+            m_Warning = "File " + filenameStdStr + " opened successfully, but its file extension (" + actualFileExtension +
+                        ") does not match file contents. Correct extension for "
+                        "that file should be " + expectedFileExtension + ".";
         }
 
-        if (m_FormatMapper)
-        {
-            m_FormatMapper->Release();
-            m_FormatMapper = nullptr;
-        }
+        // Readback slots are allocated by DecompressFrame, once memory limit for the frame is known.
+        m_RegisteredFileName = patchedFileName;
+        return CE::ZCE_SUCCESS;
+    }
 
-        if (m_Decompressor)
-        {
+    void DecompressorManager::SetMemoryLimitPerResource(size_t limitInBytes) noexcept
+    {
+        m_MemoryLimitOverride = limitInBytes;
+    }
 
-            m_Decompressor->Release();
-            m_Decompressor = nullptr;
-        }
-        status = m_DecompressorFactory->Create(&m_Decompressor);
+    CE::ReturnCode DecompressorManager::AcquireDecompressorLease(const std::string& filename, size_t memoryLimitPerResource) noexcept
+    {
+        DecompressorPool::DecompressorLease lease{};
+        auto status = DecompressorPool::GetInstance().AcquireDecompressor(filename, memoryLimitPerResource, &lease);
         if (status != CE::ZCE_SUCCESS)
         {
             return status;
         }
 
-        status = m_Decompressor->Initialize();
+        ReleaseDecompressorLease();
+        m_Decoder = lease.decoder;
+        m_Decompressor = lease.decompressor;
+        m_FormatMapper = lease.formatMapper;
+        m_MemoryLimitPerResource = memoryLimitPerResource;
+        m_ResourcesRequirements = m_Decompressor->GetResourcesRequirements();
+        return CE::ZCE_SUCCESS;
+    }
+
+    CE::ReturnCode DecompressorManager::SwitchDecompressorLease(size_t memoryLimitPerResource) noexcept
+    {
+        DecompressorPool::DecompressorLease currentLease{};
+        currentLease.decoder = m_Decoder;
+        currentLease.decompressor = m_Decompressor;
+        currentLease.formatMapper = m_FormatMapper;
+
+        DecompressorPool::DecompressorLease lease{};
+        auto status = DecompressorPool::GetInstance().SwitchDecompressor(currentLease, memoryLimitPerResource, &lease);
         if (status != CE::ZCE_SUCCESS)
         {
             return status;
         }
 
-        m_FormatMapper = static_cast<CE::Decompression::CAPI::FormatMapperCAPI*>(m_Decompressor->GetFormatMapper());
-        if (!m_FormatMapper)
+        m_Decompressor = lease.decompressor;
+        m_FormatMapper = lease.formatMapper;
+        m_MemoryLimitPerResource = memoryLimitPerResource;
+        m_ResourcesRequirements = m_Decompressor->GetResourcesRequirements();
+        return CE::ZCE_SUCCESS;
+    }
+
+    size_t DecompressorManager::GetMaxMemoryLimitPerResource() const noexcept
+    {
+        if (m_MemoryLimitOverride != 0)
         {
-            return status;
+            return m_MemoryLimitOverride;
         }
-                
-        std::string filenameStdStr = patchedFileName.toStdString();
-        std::string actualFileExtension = Helpers::GetExtension(filenameStdStr);
-        std::string expectedFileExtension = m_FormatMapper->GetExpectedFileExtension();
 
-        if (actualFileExtension != expectedFileExtension)
+        const size_t envLimit = Helpers::GetDecompressionMemoryLimitOverride();
+        if (envLimit != 0)
         {
-            m_Warning = "File " + filenameStdStr + " opened successfully, but its file extension (" + actualFileExtension +
-                        ") does not match file contents. Correct extension for "
-                        "that file should be " + expectedFileExtension + ".";
+            return envLimit;
         }
 
-        CE::Decompression::DecompressorResourcesRequirements newRequirements = m_Decompressor->GetResourcesRequirements();
-        status =
-            AllocateExternalBuffer(m_DecompressionPerChannelBlockDataBuffer, newRequirements.decompressionPerChannelBlockDataSizeInBytes,
-                                   newRequirements.decompressionPerChannelBlockDataStride);
-        if (status != CE::ZCE_SUCCESS)
+        const uint64_t physicalMemorySize = Helpers::GetPhysicalMemorySize();
+        if (physicalMemorySize == 0)
         {
-            return status;
+            using namespace Zibra::CE::Literals::Memory;
+            return 128_MiB;
         }
-        status =
-            AllocateExternalBuffer(m_DecompressionPerChannelBlockInfoBuffer, newRequirements.decompressionPerChannelBlockInfoSizeInBytes,
-                                   newRequirements.decompressionPerChannelBlockInfoStride);
-        if (status != CE::ZCE_SUCCESS)
+
+        // Software device decompresses on CPU and competes with Houdini for the same memory.
+        uint64_t autoLimit = physicalMemorySize / AUTO_MEMORY_LIMIT_PHYSICAL_MEMORY_DIVISOR;
+        if (Helpers::NeedForceSoftwareDevice())
         {
-            return status;
+            autoLimit /= 2;
         }
-        status =
-            AllocateExternalBuffer(m_DecompressionPerSpatialBlockInfoBuffer, newRequirements.decompressionPerSpatialBlockInfoSizeInBytes,
-                                   newRequirements.decompressionPerSpatialBlockInfoStride);
-        if (status != CE::ZCE_SUCCESS)
+        size_t result = MIN_MEMORY_LIMIT_PER_RESOURCE;
+        while (result * 2 <= std::min<uint64_t>(autoLimit, MAX_AUTO_MEMORY_LIMIT_PER_RESOURCE))
         {
-            return status;
+            result *= 2;
         }
+        return result;
+    }
 
-        if (m_DecompressionPerChannelBlockDataBuffer.buffer != nullptr && m_DecompressionPerChannelBlockInfoBuffer.buffer != nullptr &&
-            m_DecompressionPerSpatialBlockInfoBuffer.buffer != nullptr)
+    size_t DecompressorManager::SelectMemoryLimitPerResource(const CE::Decompression::FrameInfo& frameInfo) const noexcept
+    {
+        const size_t maxLimit = GetMaxMemoryLimitPerResource();
+        // Channel block data is the largest resource, other resources are much smaller.
+        const size_t requiredSize = size_t(frameInfo.channelBlockCount) * CE::SPARSE_BLOCK_VOXEL_COUNT * sizeof(uint16_t);
+        size_t result = MIN_MEMORY_LIMIT_PER_RESOURCE;
+        while (result < requiredSize && result < maxLimit)
         {
-            CE::Decompression::DecompressorResources decompressorResources{};
-            decompressorResources.decompressionPerChannelBlockData = m_DecompressionPerChannelBlockDataBuffer.buffer;
-            decompressorResources.decompressionPerChannelBlockInfo = m_DecompressionPerChannelBlockInfoBuffer.buffer;
-            decompressorResources.decompressionPerSpatialBlockInfo = m_DecompressionPerSpatialBlockInfoBuffer.buffer;
-            status = m_Decompressor->RegisterResources(decompressorResources);
-            if (status != CE::ZCE_SUCCESS)
-            {
-                return status;
-            }
+            result *= 2;
         }
-
-        return CE::ZCE_SUCCESS;
+        return std::min(result, maxLimit);
     }
 
     CE::ReturnCode DecompressorManager::DecompressFrame(CE::Decompression::CompressedFrameContainer* frameContainer,
                                                         std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> gridShuffle,
-                                                        openvdb::GridPtrVec* vdbGrids) noexcept
+                                                        openvdb::GridPtrVec* vdbGrids, const FrameDecodeOptions& options) noexcept
+    {
+        return DecompressFrameImpl(frameContainer, std::move(gridShuffle), vdbGrids, options, nullptr);
+    }
+
+    CE::ReturnCode DecompressorManager::DecompressFrameImpl(CE::Decompression::CompressedFrameContainer* frameContainer,
+                                                            std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> gridShuffle,
+                                                            openvdb::GridPtrVec* vdbGrids, const FrameDecodeOptions& options,
+                                                            const SpatialBlockIndex::Key* indexKey) noexcept
     {
         if (!m_RHIRuntime || !m_Decompressor)
         {
             return CE::ZCE_ERROR;
         }
-        auto RHIStatus = m_RHIRuntime->StartRecording();
-        if (RHIStatus != RHI::ZRHI_SUCCESS)
-        {
-            return CE::ZCE_ERROR;
-        }
 
         const auto frameInfo = frameContainer->GetInfo();
 
-        // Filling default mapping if metadata is empty/invalid
+        PrepareGridShuffle(frameInfo, gridShuffle, options);
         if (gridShuffle.empty())
         {
-            for (size_t i = 0; i < frameInfo.channelsCount; ++i)
+            vdbGrids->clear();
+            return CE::ZCE_SUCCESS;
+        }
+
+        SpatialBlockFilter filter{};
+        uint32_t& requiredChannelMask = filter.requiredChannelMask;
+        for (size_t i = 0; i < frameInfo.channelsCount; ++i)
+        {
+            for (const CE::Addons::OpenVDBUtils::VDBGridDesc& gridDesc : gridShuffle)
             {
-                CE::Addons::OpenVDBUtils::VDBGridDesc gridDesc{};
-                gridDesc.gridName = frameInfo.channels[i].name;
-                gridDesc.voxelType = CE::Addons::OpenVDBUtils::GridVoxelType::Float1;
-                gridDesc.chSource[0] = frameInfo.channels[i].name;
-                gridShuffle.emplace_back(gridDesc);
+                for (const char* chSource : gridDesc.chSource)
+                {
+                    if (chSource && strcmp(chSource, frameInfo.channels[i].name) == 0)
+                    {
+                        requiredChannelMask |= 1u << i;
+                    }
+                }
             }
         }
 
@@ -273,76 +403,389 @@ namespace Zibra::Helpers
         }
 
         CE::Addons::OpenVDBUtils::FrameEncoder encoder{gridShuffle.data(), gridShuffle.size(), frameInfo, encodingMetadata};
+        CE::Addons::OpenVDBUtils::GridConstructionOptions constructionOptions{};
+        constructionOptions.deactivateBackground = options.deactivateBackground;
+        constructionOptions.backgroundTolerance = options.backgroundTolerance;
+        constructionOptions.collapseUniformBlocks = options.collapseUniformBlocks;
+        constructionOptions.uniformTolerance = options.uniformTolerance;
+        constructionOptions.precision = options.precision;
+        encoder.SetConstructionOptions(constructionOptions);
+
+        if (options.regionOfInterest.has_value())
+        {
+            filter.regionBounds = ComputeRegionBounds(*options.regionOfInterest, encoder, requiredChannelMask, encodingMetadata);
+        }
 
-        const CE::Decompression::MaxDimensionsPerSubmit maxDimensionsPerSubmit = m_Decompressor->GetMaxDimensionsPerSubmit();
-        const uint32_t maxChunkSize = static_cast<uint32_t>(maxDimensionsPerSubmit.maxSpatialBlocks);
-        const uint32_t chunksCount = (frameInfo.spatialBlockCount + maxChunkSize - 1) / maxChunkSize;
+        const size_t groupsCount = (frameInfo.spatialBlockCount + SpatialBlockIndex::GROUP_SIZE - 1) / SpatialBlockIndex::GROUP_SIZE;
+        std::vector<BlockBounds> indexedGroupBounds;
+        const bool isFrameIndexed = indexKey && SpatialBlockIndex::GetInstance().Find(*indexKey, &indexedGroupBounds) &&
+                                    indexedGroupBounds.size() == groupsCount;
 
-        std::vector<CE::Decompression::Shaders::PackedSpatialBlockInfo> readbackDecompressionPerSpatialBlockInfo{};
-        readbackDecompressionPerSpatialBlockInfo.reserve(maxChunkSize);
-        std::vector<uint16_t> readbackDecompressionPerChannelBlockData{};
-        readbackDecompressionPerChannelBlockData.reserve(maxChunkSize * CE::MAX_CHANNEL_COUNT * CE::SPARSE_BLOCK_VOXEL_COUNT);
+        // Runtime is shared with other managers, so device is locked around GPU work and readback.
+        // Chunks are encoded and grids are constructed without the lock.
+        std::recursive_mutex& deviceMutex = DecompressorPool::GetInstance().GetDeviceMutex();
 
-        for (int chunkIdx = 0; chunkIdx < chunksCount; ++chunkIdx)
+        size_t maxChunkSize = 0;
         {
-            CE::Decompression::DecompressFrameDesc decompressDesc{};
-            decompressDesc.frameContainer = frameContainer;
-            decompressDesc.firstSpatialBlockIndex = maxChunkSize * chunkIdx;
-            decompressDesc.spatialBlocksCount = std::min(maxChunkSize, frameInfo.spatialBlockCount - maxChunkSize * chunkIdx);
-            decompressDesc.decompressionPerChannelBlockDataOffset = 0;
-            decompressDesc.decompressionPerChannelBlockInfoOffset = 0;
-            decompressDesc.decompressionPerSpatialBlockInfoOffset = 0;
+            std::lock_guard deviceLock(deviceMutex);
+            maxChunkSize = m_Decompressor->GetMaxDimensionsPerSubmit().maxSpatialBlocks;
+        }
 
-            CE::Decompression::DecompressedFrameFeedback fFeedback{};
+        std::vector<SpatialBlockRange> chunks;
+        auto appendChunks = [&](size_t firstSpatialBlockIndex, size_t endSpatialBlockIndex) {
+            for (size_t chunkFirst = firstSpatialBlockIndex; chunkFirst < endSpatialBlockIndex; chunkFirst += maxChunkSize)
+            {
+                chunks.push_back({chunkFirst, std::min(maxChunkSize, endSpatialBlockIndex - chunkFirst)});
+            }
+        };
+        if (filter.regionBounds.has_value() && isFrameIndexed)
+        {
+            filter.indexedGroupBounds = &indexedGroupBounds;
+            // Consecutive groups that intersect region are merged, so they are decompressed with as few submits as possible.
+            size_t runFirstGroup = 0;
+            for (size_t groupIdx = 0; groupIdx <= groupsCount; ++groupIdx)
+            {
+                if (groupIdx < groupsCount && indexedGroupBounds[groupIdx].Intersects(*filter.regionBounds))
+                {
+                    continue;
+                }
+                appendChunks(runFirstGroup * SpatialBlockIndex::GROUP_SIZE,
+                             std::min<size_t>(groupIdx * SpatialBlockIndex::GROUP_SIZE, frameInfo.spatialBlockCount));
+                runFirstGroup = groupIdx + 1;
+            }
+        }
+        else
+        {
+            appendChunks(0, frameInfo.spatialBlockCount);
+        }
 
-            CE::Decompression::ReturnCode status = m_Decompressor->DecompressFrame(decompressDesc, &fFeedback);
+        // Index is built while whole frame is read back, so it costs only one pass over spatial block info that is read anyway.
+        std::vector<BlockBounds> builtGroupBounds;
+        if (indexKey && !isFrameIndexed)
+        {
+            builtGroupBounds.resize(groupsCount);
+        }
+
+        const uint32_t chunksCount = static_cast<uint32_t>(chunks.size());
+        const uint32_t ringSlotsCount = std::max(1u, std::min(chunksCount, READBACK_RING_SLOT_COUNT));
+
+        for (uint32_t slotIdx = 0; slotIdx < ringSlotsCount; ++slotIdx)
+        {
+            CE::ReturnCode status = AllocateReadbackSlot(m_ReadbackRing[slotIdx]);
             if (status != CE::ZCE_SUCCESS)
             {
                 return status;
             }
+        }
+
+        // Serial path encodes each chunk right after readback on calling thread, which is useful for debugging.
+        ChunkEncodingPipeline* encodingPipeline = nullptr;
+        if (!Helpers::NeedSerialDecompression())
+        {
+            if (!m_EncodingPipeline)
+            {
+                m_EncodingPipeline =
+                    std::make_unique<ChunkEncodingPipeline>(m_HostChunkBuffers.data(), m_HostChunkBuffers.size(), &m_Timings);
+            }
+            encodingPipeline = m_EncodingPipeline.get();
+            encodingPipeline->Begin(encoder, encodingMetadata);
+        }
+
+        // Chunk N is decompressed into ring slot N % ringSlotsCount and is read back only after chunk N + ringSlotsCount - 1
+        // has been submitted. That way readback of the oldest chunk only waits for its own GPU work,
+        // while GPU keeps decompressing following chunks into other slots.
+        // Every step is recorded separately, so device is released while previous chunks are encoded.
+        // Submitted chunks only depend on buffers of their own readback slot, which are not shared with other managers.
+        // Encoder is local to this call, so pipeline is drained on every exit path before encoder goes out of scope.
+        bool isIndexMismatch = false;
+        auto decompressChunks = [&]() noexcept -> CE::ReturnCode {
+            for (uint32_t stepIdx = 0; stepIdx < chunksCount + ringSlotsCount - 1; ++stepIdx)
+            {
+                const bool isReadbackStep = stepIdx + 1 >= ringSlotsCount;
+                const ReadbackSlot* readbackSlot = nullptr;
+                HostChunkBuffer* hostBuffer = nullptr;
+                if (isReadbackStep)
+                {
+                    readbackSlot = &m_ReadbackRing[(stepIdx + 1 - ringSlotsCount) % ringSlotsCount];
+                    // Waiting for free host buffer may take a while, so it's done before device is locked
+                    hostBuffer = encodingPipeline ? encodingPipeline->AcquireBuffer() : &m_HostChunkBuffers[0];
+                }
+
+                CE::ReturnCode status = CE::ZCE_SUCCESS;
+                {
+                    std::lock_guard deviceLock(deviceMutex);
+                    if (m_RHIRuntime->StartRecording() != RHI::ZRHI_SUCCESS)
+                    {
+                        return CE::ZCE_ERROR;
+                    }
+                    if (stepIdx < chunksCount)
+                    {
+                        status = SubmitChunk(frameContainer, chunks[stepIdx].firstSpatialBlockIndex, chunks[stepIdx].spatialBlocksCount,
+                                             m_ReadbackRing[stepIdx % ringSlotsCount]);
+                    }
+                    if (status == CE::ZCE_SUCCESS && isReadbackStep)
+                    {
+                        {
+                            ScopedStageTimer timer(&m_Timings, DecodeTimings::Stage::Readback);
+                            status = GetDecompressedFrameData(*readbackSlot, filter, *hostBuffer,
+                                                              builtGroupBounds.empty() ? nullptr : &builtGroupBounds, &isIndexMismatch);
+                        }
+                        m_RHIRuntime->GarbageCollect();
+                    }
+                    // Recording is stopped on failure too, so runtime is left in a usable state for other managers
+                    if (m_RHIRuntime->StopRecording() != RHI::ZRHI_SUCCESS && status == CE::ZCE_SUCCESS)
+                    {
+                        status = CE::ZCE_ERROR;
+                    }
+                }
+                if (status != CE::ZCE_SUCCESS)
+                {
+                    return status;
+                }
+                if (!isReadbackStep)
+                {
+                    continue;
+                }
+
+                if (encodingPipeline)
+                {
+                    encodingPipeline->Submit(hostBuffer);
+                    continue;
+                }
+
+                ScopedStageTimer timer(&m_Timings, DecodeTimings::Stage::EncodeChunks);
+                CE::Addons::OpenVDBUtils::FrameData fData{};
+                fData.decompressionPerChannelBlockData = hostBuffer->perChannelBlockData.data();
+                fData.decompressionPerSpatialBlockInfo = hostBuffer->perSpatialBlockInfo.data();
+                encoder.EncodeChunk(fData, hostBuffer->spatialBlocksCount, hostBuffer->firstChannelBlockIndex, encodingMetadata);
+            }
+            return CE::ZCE_SUCCESS;
+        };
+        const CE::ReturnCode chunksStatus = decompressChunks();
+        if (encodingPipeline)
+        {
+            encodingPipeline->Finish();
+        }
+        if (chunksStatus != CE::ZCE_SUCCESS)
+        {
+            return chunksStatus;
+        }
+        m_Timings.Add(DecodeTimings::Stage::ConstructGrids, encoder.GetGridConstructionTime());
 
-            readbackDecompressionPerSpatialBlockInfo.resize(decompressDesc.spatialBlocksCount);
-            readbackDecompressionPerChannelBlockData.resize(fFeedback.channelBlocksCount * CE::SPARSE_BLOCK_VOXEL_COUNT);
-            GetDecompressedFrameData(readbackDecompressionPerChannelBlockData.data(), fFeedback.channelBlocksCount,
-                                     readbackDecompressionPerSpatialBlockInfo.data(), decompressDesc.spatialBlocksCount);
-            m_RHIRuntime->GarbageCollect();
+        if (isIndexMismatch)
+        {
+            // Blocks of skipped groups may be missing, so frame is decompressed again without index.
+            // That decompression reads back whole frame and replaces index with one built from actual blocks.
+            SpatialBlockIndex::GetInstance().Erase(*indexKey);
+            return DecompressFrameImpl(frameContainer, gridShuffle, vdbGrids, options, indexKey);
+        }
 
-            CE::Addons::OpenVDBUtils::FrameData fData{};
-            fData.decompressionPerChannelBlockData = readbackDecompressionPerChannelBlockData.data();
-            fData.decompressionPerSpatialBlockInfo = readbackDecompressionPerSpatialBlockInfo.data();
-            // TODO VDB-1291: Implement read-back circular buffer, to optimize GPU stalls.
-            //                Implement cpu circular buffer to optimize RAM allocation for DecompressedFrameData.
-            //                Move EncodeChunk into separate thread to overlay CPU and CPU work.
-            encoder.EncodeChunk(fData, decompressDesc.spatialBlocksCount, fFeedback.firstChannelBlockIndex, encodingMetadata);
+        if (!builtGroupBounds.empty())
+        {
+            SpatialBlockIndex::GetInstance().Insert(*indexKey, std::move(builtGroupBounds));
         }
-        RHIStatus = m_RHIRuntime->StopRecording();
-        if (RHIStatus != RHI::ZRHI_SUCCESS)
+
+        *vdbGrids = encoder.ReleaseGrids();
+        return CE::ZCE_SUCCESS;
+    }
+
+    CE::ReturnCode DecompressorManager::DecompressFrameCached(exint frameIndex, const FrameDecodeOptions& options,
+                                                              openvdb::GridPtrVec* vdbGrids,
+                                                              CE::Decompression::CompressedFrameContainer** outFrameMetadata) noexcept
+    {
+        if (!m_FormatMapper)
         {
             return CE::ZCE_ERROR;
         }
 
-        *vdbGrids = encoder.GetGrids();
+        // Key only depends on requested options, so cache is checked before anything is read from file.
+        DecodedFrameCache::Key key{};
+        const CE::Decompression::SequenceInfo sequenceInfo = m_FormatMapper->GetSequenceInfo();
+        key.fileUUID[0] = sequenceInfo.fileUUID[0];
+        key.fileUUID[1] = sequenceInfo.fileUUID[1];
+        key.frameIndex = frameIndex;
+        for (const std::string& gridName : options.gridNames)
+        {
+            key.channelSet += gridName + '\n';
+        }
+        if (options.regionOfInterest.has_value())
+        {
+            const RegionOfInterest& regionOfInterest = *options.regionOfInterest;
+            std::ostringstream regionStream;
+            regionStream << static_cast<int>(regionOfInterest.space) << ' ' << regionOfInterest.bbox;
+            key.region = regionStream.str();
+        }
+        if (options.deactivateBackground)
+        {
+            key.gridOptions += "deactivate " + std::to_string(options.backgroundTolerance) + '\n';
+        }
+        if (options.collapseUniformBlocks)
+        {
+            key.gridOptions += "collapse " + std::to_string(options.uniformTolerance) + '\n';
+        }
+        if (options.precision != CE::Addons::OpenVDBUtils::GridPrecision::Float32)
+        {
+            key.gridOptions += "precision " + std::to_string(static_cast<int>(options.precision)) + '\n';
+        }
+
+        FrameMetadataSnapshot* frameMetadata = nullptr;
+        if (DecodedFrameCache::GetInstance().Find(key, vdbGrids, &frameMetadata))
+        {
+            *outFrameMetadata = frameMetadata;
+            return CE::ZCE_SUCCESS;
+        }
+
+        CE::Decompression::CompressedFrameContainer* frameContainer = FetchFrame(frameIndex);
+        if (!frameContainer)
+        {
+            return CE::ZCE_ERROR_NOT_FOUND;
+        }
+
+        vdbGrids->clear();
+        CE::ReturnCode status = CE::ZCE_SUCCESS;
+        if (frameContainer->GetInfo().spatialBlockCount != 0)
+        {
+            SpatialBlockIndex::Key indexKey{};
+            indexKey.fileUUID[0] = key.fileUUID[0];
+            indexKey.fileUUID[1] = key.fileUUID[1];
+            indexKey.frameIndex = key.frameIndex;
+
+            // Grid shuffle is filtered by a copy, so every deserialized entry is released here.
+            std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> gridShuffle = DeserializeGridShuffleInfo(frameContainer);
+            status = DecompressFrameImpl(frameContainer, gridShuffle, vdbGrids, options, &indexKey);
+            ReleaseGridShuffleInfo(gridShuffle);
+        }
+
+        // Container is only valid while its format mapper is alive, so metadata is copied out before it's released.
+        if (status == CE::ZCE_SUCCESS)
+        {
+            frameMetadata = FrameMetadataSnapshot::Create(frameContainer);
+        }
+        frameContainer->Release();
+        if (status != CE::ZCE_SUCCESS)
+        {
+            vdbGrids->clear();
+            return status;
+        }
+
+        DecodedFrameCache::GetInstance().Insert(key, *vdbGrids, *frameMetadata);
+        *outFrameMetadata = frameMetadata;
         return CE::ZCE_SUCCESS;
     }
 
-    CE::ReturnCode DecompressorManager::GetDecompressedFrameData(uint16_t* perChannelBlockData, size_t channelBlocksCount,
-                                                                 CE::Decompression::Shaders::PackedSpatialBlockInfo* perSpatialBlockInfo,
-                                                                 size_t spatialBlocksCount) const noexcept
+    CE::ReturnCode DecompressorManager::SubmitChunk(CE::Decompression::CompressedFrameContainer* frameContainer,
+                                                    size_t firstSpatialBlockIndex, size_t spatialBlocksCount, ReadbackSlot& slot) noexcept
+    {
+        ScopedStageTimer timer(&m_Timings, DecodeTimings::Stage::SubmitDecompression);
+
+        // Decompressor writes to the last registered resources, so slot buffers are registered before each submit.
+        CE::Decompression::DecompressorResources decompressorResources{};
+        decompressorResources.decompressionPerChannelBlockData = slot.perChannelBlockData.buffer;
+        decompressorResources.decompressionPerChannelBlockInfo = slot.perChannelBlockInfo.buffer;
+        decompressorResources.decompressionPerSpatialBlockInfo = slot.perSpatialBlockInfo.buffer;
+        auto status = m_Decompressor->RegisterResources(decompressorResources);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            return status;
+        }
+
+        CE::Decompression::DecompressFrameDesc decompressDesc{};
+        decompressDesc.frameContainer = frameContainer;
+        decompressDesc.firstSpatialBlockIndex = firstSpatialBlockIndex;
+        decompressDesc.spatialBlocksCount = spatialBlocksCount;
+        decompressDesc.decompressionPerChannelBlockDataOffset = 0;
+        decompressDesc.decompressionPerChannelBlockInfoOffset = 0;
+        decompressDesc.decompressionPerSpatialBlockInfoOffset = 0;
+
+        slot.firstSpatialBlockIndex = firstSpatialBlockIndex;
+        slot.spatialBlocksCount = spatialBlocksCount;
+        slot.feedback = {};
+        return m_Decompressor->DecompressFrame(decompressDesc, &slot.feedback);
+    }
+
+    CE::ReturnCode DecompressorManager::GetDecompressedFrameData(const ReadbackSlot& slot, const SpatialBlockFilter& filter,
+                                                                 HostChunkBuffer& hostBuffer, std::vector<BlockBounds>* groupBounds,
+                                                                 bool* isIndexMismatch) const noexcept
     {
         if (!m_RHIRuntime)
         {
             return CE::ZCE_ERROR;
         }
 
-        auto RHIstatus = m_RHIRuntime->GetBufferDataImmediately(m_DecompressionPerSpatialBlockInfoBuffer.buffer, perSpatialBlockInfo,
-                                                                spatialBlocksCount * sizeof(perSpatialBlockInfo[0]), 0);
+        // Host buffers are reused between chunks and frames, so resize only reallocates when chunk is bigger than any previous one.
+        hostBuffer.spatialBlocksCount = slot.spatialBlocksCount;
+        hostBuffer.firstChannelBlockIndex = slot.feedback.firstChannelBlockIndex;
+        hostBuffer.perSpatialBlockInfo.resize(slot.spatialBlocksCount);
+        hostBuffer.perChannelBlockData.resize(slot.feedback.channelBlocksCount * CE::SPARSE_BLOCK_VOXEL_COUNT);
+
+        // Only waits for GPU work that writes to this slot buffers, chunks submitted to other slots keep executing.
+        auto RHIstatus = m_RHIRuntime->GetBufferDataImmediately(slot.perSpatialBlockInfo.buffer, hostBuffer.perSpatialBlockInfo.data(),
+                                                                hostBuffer.perSpatialBlockInfo.size() * sizeof(hostBuffer.perSpatialBlockInfo[0]), 0);
         if (RHIstatus != RHI::ZRHI_SUCCESS)
         {
             return CE::ZCE_ERROR;
         }
-        const size_t channelBlockDataElementCount = channelBlocksCount * CE::SPARSE_BLOCK_VOXEL_COUNT;
-        RHIstatus = m_RHIRuntime->GetBufferDataImmediately(m_DecompressionPerChannelBlockDataBuffer.buffer, perChannelBlockData,
-                                                           channelBlockDataElementCount * sizeof(perChannelBlockData[0]), 0);
+
+        // Channel blocks of spatial blocks without required channels are never accessed by encoder, so they are not read back.
+        // Channel blocks keep their positions in host buffer, so spatial block info stays valid.
+        const size_t channelBlockSize = CE::SPARSE_BLOCK_VOXEL_COUNT * sizeof(hostBuffer.perChannelBlockData[0]);
+        auto readbackChannelBlocks = [&](size_t firstBlock, size_t endBlock) {
+            if (firstBlock >= endBlock)
+            {
+                return RHI::ZRHI_SUCCESS;
+            }
+            return m_RHIRuntime->GetBufferDataImmediately(slot.perChannelBlockData.buffer,
+                                                          hostBuffer.perChannelBlockData.data() + firstBlock * CE::SPARSE_BLOCK_VOXEL_COUNT,
+                                                          (endBlock - firstBlock) * channelBlockSize, firstBlock * channelBlockSize);
+        };
+
+        size_t runFirstBlock = 0;
+        size_t runEndBlock = 0;
+        for (size_t spatialIdx = 0; spatialIdx < hostBuffer.perSpatialBlockInfo.size(); ++spatialIdx)
+        {
+            CE::Decompression::Shaders::PackedSpatialBlockInfo& spatialBlock = hostBuffer.perSpatialBlockInfo[spatialIdx];
+            if (groupBounds || filter.regionBounds.has_value())
+            {
+                const CE::SpatialBlockInfo blockInfo = CE::Decompression::UnpackPackedSpatialBlockInfo(spatialBlock);
+                const size_t groupIdx = (slot.firstSpatialBlockIndex + spatialIdx) / SpatialBlockIndex::GROUP_SIZE;
+                if (groupBounds)
+                {
+                    (*groupBounds)[groupIdx].Extend(blockInfo.coords);
+                }
+                if (filter.indexedGroupBounds && !(*filter.indexedGroupBounds)[groupIdx].Contains(blockInfo.coords))
+                {
+                    *isIndexMismatch = true;
+                }
+                if (filter.regionBounds.has_value() && !filter.regionBounds->Contains(blockInfo.coords))
+                {
+                    // Encoder doesn't create leafs for spatial blocks with empty channel mask
+                    spatialBlock.channelMask = 0;
+                    continue;
+                }
+            }
+
+            if ((spatialBlock.channelMask & filter.requiredChannelMask) == 0)
+            {
+                continue;
+            }
+            const size_t blockFirst = spatialBlock.channelBlocksOffset - hostBuffer.firstChannelBlockIndex;
+            const size_t blockEnd = blockFirst + CE::CountBits(spatialBlock.channelMask);
+            if (runEndBlock != 0 && blockFirst > runEndBlock + READBACK_MIN_SKIPPED_CHANNEL_BLOCKS)
+            {
+                RHIstatus = readbackChannelBlocks(runFirstBlock, runEndBlock);
+                if (RHIstatus != RHI::ZRHI_SUCCESS)
+                {
+                    return CE::ZCE_ERROR;
+                }
+                runFirstBlock = blockFirst;
+            }
+            else if (runEndBlock == 0)
+            {
+                runFirstBlock = blockFirst;
+            }
+            runEndBlock = std::max(runEndBlock, blockEnd);
+        }
+        RHIstatus = readbackChannelBlocks(runFirstBlock, runEndBlock);
         if (RHIstatus != RHI::ZRHI_SUCCESS)
         {
             return CE::ZCE_ERROR;
@@ -351,18 +794,138 @@ namespace Zibra::Helpers
         return CE::ZCE_SUCCESS;
     }
 
-    CE::Decompression::CompressedFrameContainer* DecompressorManager::FetchFrame(const exint& frameIndex) const noexcept
+    BlockBounds DecompressorManager::ComputeRegionBounds(const RegionOfInterest& regionOfInterest,
+                                                         const CE::Addons::OpenVDBUtils::FrameEncoder& encoder, uint32_t requiredChannelMask,
+                                                         const CE::Addons::OpenVDBUtils::EncodingMetadata* encodingMetadata) noexcept
+    {
+        BlockBounds result{};
+        if (regionOfInterest.bbox.empty())
+        {
+            return result;
+        }
+
+        // Channels may have different transforms, so union of region bounds in index space of every channel is used.
+        openvdb::BBoxd indexBBox{};
+        for (size_t i = 0; i < CE::MAX_CHANNEL_COUNT; ++i)
+        {
+            if ((requiredChannelMask & (1u << i)) == 0)
+            {
+                continue;
+            }
+            if (regionOfInterest.space == RegionOfInterest::Space::Index)
+            {
+                indexBBox = regionOfInterest.bbox;
+                break;
+            }
+            indexBBox.expand(encoder.GetChannelTransform(i)->worldToIndex(regionOfInterest.bbox));
+        }
+        if (indexBBox.empty())
+        {
+            return result;
+        }
+
+        const int32_t offset[3] = {encodingMetadata ? encodingMetadata->offsetX / CE::SPARSE_BLOCK_SIZE : 0,
+                                   encodingMetadata ? encodingMetadata->offsetY / CE::SPARSE_BLOCK_SIZE : 0,
+                                   encodingMetadata ? encodingMetadata->offsetZ / CE::SPARSE_BLOCK_SIZE : 0};
+        // Voxels that partially overlap region are included. Bounds are clamped to the range packed coordinates can represent.
+        static constexpr double MAX_PACKED_COORD = 1023.0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const double minBlock = std::floor(std::floor(indexBBox.min()[axis]) / CE::SPARSE_BLOCK_SIZE) - offset[axis];
+            const double maxBlock = std::floor(std::ceil(indexBBox.max()[axis]) / CE::SPARSE_BLOCK_SIZE) - offset[axis];
+            result.min[axis] = static_cast<int32_t>(std::clamp(minBlock, -1.0, MAX_PACKED_COORD + 1.0));
+            result.max[axis] = static_cast<int32_t>(std::clamp(maxBlock, -1.0, MAX_PACKED_COORD + 1.0));
+        }
+        return result;
+    }
+
+    void DecompressorManager::PrepareGridShuffle(const CE::Decompression::FrameInfo& frameInfo,
+                                                 std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc>& gridShuffle,
+                                                 const FrameDecodeOptions& options) noexcept
+    {
+        // Filling default mapping if metadata is empty/invalid
+        if (gridShuffle.empty())
+        {
+            for (size_t i = 0; i < frameInfo.channelsCount; ++i)
+            {
+                CE::Addons::OpenVDBUtils::VDBGridDesc gridDesc{};
+                gridDesc.gridName = frameInfo.channels[i].name;
+                gridDesc.voxelType = CE::Addons::OpenVDBUtils::GridVoxelType::Float1;
+                gridDesc.chSource[0] = frameInfo.channels[i].name;
+                gridShuffle.emplace_back(gridDesc);
+            }
+        }
+
+        if (options.gridNames.empty())
+        {
+            return;
+        }
+
+        // Strings are owned by caller's copy of grid shuffle, so dropped entries are not released here.
+        auto isGridSelected = [&](const CE::Addons::OpenVDBUtils::VDBGridDesc& gridDesc) {
+            if (options.gridNames.find(gridDesc.gridName) != options.gridNames.end())
+            {
+                return true;
+            }
+            for (const char* chSource : gridDesc.chSource)
+            {
+                if (chSource && options.gridNames.find(chSource) != options.gridNames.end())
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+        gridShuffle.erase(std::remove_if(gridShuffle.begin(), gridShuffle.end(),
+                                         [&](const CE::Addons::OpenVDBUtils::VDBGridDesc& gridDesc) { return !isGridSelected(gridDesc); }),
+                          gridShuffle.end());
+    }
+
+    CE::Decompression::CompressedFrameContainer* DecompressorManager::FetchFrame(const exint& frameIndex) noexcept
     {
         if (!m_FormatMapper)
         {
             return nullptr;
         }
+        ScopedStageTimer timer(&m_Timings, DecodeTimings::Stage::FetchFrame);
+        std::lock_guard deviceLock(DecompressorPool::GetInstance().GetDeviceMutex());
+
+        // Frame container can only be decompressed by decompressor of format mapper that fetched it,
+        // so decompressor is switched before fetching the frame.
+        CE::Decompression::FrameInfo frameInfo{};
+        if (m_FormatMapper->FetchFrameInfo(frameIndex, &frameInfo) == CE::ZCE_SUCCESS)
+        {
+            const size_t memoryLimitPerResource = SelectMemoryLimitPerResource(frameInfo);
+            if (memoryLimitPerResource != m_MemoryLimitPerResource && SwitchDecompressorLease(memoryLimitPerResource) != CE::ZCE_SUCCESS)
+            {
+                return nullptr;
+            }
+        }
+
         CE::Decompression::CompressedFrameContainer* frameContainer = nullptr;
         auto status = m_FormatMapper->FetchFrame(frameIndex, &frameContainer);
         if (status != CE::ZCE_SUCCESS)
         {
             return nullptr;
         }
+
+        // Index stored by compressor is loaded here, so even first region of interest decompression of the frame
+        // only submits spatial blocks that intersect the region.
+        const char* serializedIndex = frameContainer->GetMetadataByKey(SpatialBlockIndex::METADATA_KEY);
+        if (serializedIndex)
+        {
+            const CE::Decompression::SequenceInfo sequenceInfo = m_FormatMapper->GetSequenceInfo();
+            SpatialBlockIndex::Key indexKey{};
+            indexKey.fileUUID[0] = sequenceInfo.fileUUID[0];
+            indexKey.fileUUID[1] = sequenceInfo.fileUUID[1];
+            indexKey.frameIndex = frameIndex;
+            std::vector<BlockBounds> groupBounds;
+            if (!SpatialBlockIndex::GetInstance().Contains(indexKey) &&
+                SpatialBlockIndex::Deserialize(serializedIndex, frameContainer->GetInfo().spatialBlockCount, &groupBounds))
+            {
+                SpatialBlockIndex::GetInstance().Insert(indexKey, std::move(groupBounds));
+            }
+        }
         return frameContainer;
     }
 
@@ -375,35 +938,28 @@ namespace Zibra::Helpers
         return m_FormatMapper->GetFrameRange();
     }
 
-    CE::ReturnCode DecompressorManager::FreeExternalBuffers() noexcept
+    CE::ReturnCode DecompressorManager::FreeExternalBuffer(BufferDesc& bufferDesc) noexcept
     {
-        RHI::ReturnCode RHIstatus;
-        if (m_DecompressionPerChannelBlockDataBuffer.buffer)
+        if (bufferDesc.buffer)
         {
-            RHIstatus = m_RHIRuntime->ReleaseBuffer(m_DecompressionPerChannelBlockDataBuffer.buffer);
-            if (RHIstatus != RHI::ZRHI_SUCCESS)
-            {
-                return CE::ZCE_ERROR;
-            }
-            m_DecompressionPerChannelBlockDataBuffer = BufferDesc{};
-        }
-        if (m_DecompressionPerChannelBlockInfoBuffer.buffer)
-        {
-            RHIstatus = m_RHIRuntime->ReleaseBuffer(m_DecompressionPerChannelBlockInfoBuffer.buffer);
-            if (RHIstatus != RHI::ZRHI_SUCCESS)
-            {
-                return CE::ZCE_ERROR;
-            }
-            m_DecompressionPerChannelBlockInfoBuffer = BufferDesc{};
+            DecompressorPool::GetInstance().ReleaseBuffer(bufferDesc.buffer);
         }
-        if (m_DecompressionPerSpatialBlockInfoBuffer.buffer)
+        bufferDesc = BufferDesc{};
+        return CE::ZCE_SUCCESS;
+    }
+
+    CE::ReturnCode DecompressorManager::FreeExternalBuffers() noexcept
+    {
+        for (ReadbackSlot& slot : m_ReadbackRing)
         {
-            RHIstatus = m_RHIRuntime->ReleaseBuffer(m_DecompressionPerSpatialBlockInfoBuffer.buffer);
-            if (RHIstatus != RHI::ZRHI_SUCCESS)
+            for (BufferDesc* bufferDesc : {&slot.perChannelBlockData, &slot.perChannelBlockInfo, &slot.perSpatialBlockInfo})
             {
-                return CE::ZCE_ERROR;
+                auto status = FreeExternalBuffer(*bufferDesc);
+                if (status != CE::ZCE_SUCCESS)
+                {
+                    return status;
+                }
             }
-            m_DecompressionPerSpatialBlockInfoBuffer = BufferDesc{};
         }
         return CE::ZCE_SUCCESS;
     }
@@ -415,30 +971,36 @@ namespace Zibra::Helpers
             return;
         }
 
-        if (m_Decoder)
+        m_EncodingPipeline.reset();
         {
-            CE::Decompression::CAPI::ReleaseDecoder(m_Decoder);
-            m_Decoder = nullptr;
+            std::lock_guard deviceLock(DecompressorPool::GetInstance().GetDeviceMutex());
+            ReleaseDecompressorLease();
+            FreeExternalBuffers();
         }
+        DecompressorPool::GetInstance().ReleaseRuntime();
+        m_RHIRuntime = nullptr;
 
-        FreeExternalBuffers();
-        if (m_Decompressor)
-        {
-            m_Decompressor->Release();
-            m_Decompressor = nullptr;
-        }
-        if (m_DecompressorFactory)
-        {
-            m_DecompressorFactory->Release();
-            m_DecompressorFactory = nullptr;
-        }
-        if (m_RHIRuntime)
+        m_RegisteredFileName = "";
+        m_IsInitialized = false;
+    }
+
+    void DecompressorManager::ReleaseDecompressorLease() noexcept
+    {
+        if (!m_Decompressor)
         {
-            m_RHIRuntime->Release();
-            m_RHIRuntime = nullptr;
+            return;
         }
 
-        m_IsInitialized = false;
+        DecompressorPool::DecompressorLease lease{};
+        lease.decoder = m_Decoder;
+        lease.decompressor = m_Decompressor;
+        lease.formatMapper = m_FormatMapper;
+        DecompressorPool::GetInstance().ReleaseDecompressor(lease);
+
+        m_Decoder = nullptr;
+        m_Decompressor = nullptr;
+        m_FormatMapper = nullptr;
+        m_MemoryLimitPerResource = 0;
     }
 
     inline char* AllocateStringCopy(const std::string& src) noexcept
@@ -451,6 +1013,8 @@ namespace Zibra::Helpers
     std::vector<CE::Addons::OpenVDBUtils::VDBGridDesc> DecompressorManager::DeserializeGridShuffleInfo(
         CE::Decompression::CompressedFrameContainer* frameContainer) noexcept
     {
+        ScopedStageTimer timer(&m_Timings, DecodeTimings::Stage::ParseGridShuffle);
+
         static std::map<std::string, CE::Addons::OpenVDBUtils::GridVoxelType> strToVoxelType = {
             {"Float1", CE::Addons::OpenVDBUtils::GridVoxelType::Float1}, {"Float3", CE::Addons::OpenVDBUtils::GridVoxelType::Float3}};
 
@@ -559,9 +1123,24 @@ namespace Zibra::Helpers
         return {};
     }
 
+    const DecodeTimings& DecompressorManager::GetTimings() const noexcept
+    {
+        return m_Timings;
+    }
+
+    void DecompressorManager::ResetTimings() noexcept
+    {
+        m_Timings = {};
+    }
+
     const UT_String& DecompressorManager::GetWarning() const noexcept
     {
         return m_Warning;
     }
 
+    const UT_String& DecompressorManager::GetRegisteredFileName() const noexcept
+    {
+        return m_RegisteredFileName;
+    }
+
 } // namespace Zibra::Helpers
@@ -0,0 +1,464 @@
+#include "PrecompiledHeader.h"
+
+#include "utils/DecompressorPool.h"
+
+#include "utils/Helpers.h"
+
+namespace Zibra::Helpers
+{
+    DecompressorPool& DecompressorPool::GetInstance() noexcept
+    {
+        static DecompressorPool instance;
+        return instance;
+    }
+
+    DecompressorPool::~DecompressorPool() noexcept
+    {
+        StopReclaimThread();
+    }
+
+    CE::ReturnCode DecompressorPool::AcquireRuntime(RHI::RHIRuntime** outRuntime) noexcept
+    {
+        std::lock_guard deviceLock(m_DeviceMutex);
+        std::lock_guard lock(m_Mutex);
+
+        if (m_RuntimeRefCount == 0)
+        {
+            auto status = InitializeRuntime();
+            if (status != CE::ZCE_SUCCESS)
+            {
+                return status;
+            }
+            StartReclaimThread();
+        }
+
+        ++m_RuntimeRefCount;
+        *outRuntime = m_RHIRuntime;
+        return CE::ZCE_SUCCESS;
+    }
+
+    void DecompressorPool::ReleaseRuntime() noexcept
+    {
+        std::thread reclaimThread;
+        {
+            std::lock_guard deviceLock(m_DeviceMutex);
+            std::lock_guard lock(m_Mutex);
+
+            if (m_RuntimeRefCount == 0)
+            {
+                assert(0);
+                return;
+            }
+
+            --m_RuntimeRefCount;
+            if (m_RuntimeRefCount != 0)
+            {
+                ReclaimIdleObjects(false);
+                return;
+            }
+
+            reclaimThread = TakeReclaimThread();
+            ReclaimIdleObjects(true);
+            if (m_DecompressorFactory)
+            {
+                m_DecompressorFactory->Release();
+                m_DecompressorFactory = nullptr;
+            }
+            if (m_RHIRuntime)
+            {
+                m_RHIRuntime->Release();
+                m_RHIRuntime = nullptr;
+            }
+        }
+        if (reclaimThread.joinable())
+        {
+            reclaimThread.join();
+        }
+    }
+
+    CE::ReturnCode DecompressorPool::AcquireDecompressor(const std::string& filename, size_t memoryLimitPerResource,
+                                                         DecompressorLease* outLease) noexcept
+    {
+        std::lock_guard deviceLock(m_DeviceMutex);
+        std::lock_guard lock(m_Mutex);
+
+        if (!m_DecompressorFactory)
+        {
+            return CE::ZCE_ERROR;
+        }
+
+        ReclaimIdleObjects(false);
+
+        FileKey key{};
+        key.filename = filename;
+        std::error_code errorCode;
+        key.fileSize = std::filesystem::file_size(filename, errorCode);
+        if (!errorCode)
+        {
+            key.lastWriteTime = std::filesystem::last_write_time(filename, errorCode);
+        }
+
+        // Idle entry with decompressor for the requested limit is preferred, so nothing has to be created
+        FileEntry* idleEntry = nullptr;
+        auto [entryIt, entryEnd] = m_Files.equal_range(key);
+        for (; entryIt != entryEnd; ++entryIt)
+        {
+            FileEntry& entry = entryIt->second;
+            if (entry.isLeased)
+            {
+                continue;
+            }
+            if (!idleEntry || entry.decompressors.find(memoryLimitPerResource) != entry.decompressors.end())
+            {
+                idleEntry = &entry;
+            }
+        }
+        if (idleEntry)
+        {
+            auto status = GetOrCreateDecompressor(*idleEntry, memoryLimitPerResource, outLease);
+            if (status != CE::ZCE_SUCCESS)
+            {
+                return status;
+            }
+            idleEntry->isLeased = true;
+            return CE::ZCE_SUCCESS;
+        }
+
+        FileEntry entry{};
+        auto status = CE::Decompression::CAPI::CreateDecoder(filename.c_str(), &entry.decoder);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            return status;
+        }
+        status = GetOrCreateDecompressor(entry, memoryLimitPerResource, outLease);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            ReleaseFileEntry(entry);
+            return status;
+        }
+
+        entry.isLeased = true;
+        m_Files.emplace(key, entry);
+        return CE::ZCE_SUCCESS;
+    }
+
+    CE::ReturnCode DecompressorPool::SwitchDecompressor(const DecompressorLease& lease, size_t memoryLimitPerResource,
+                                                        DecompressorLease* outLease) noexcept
+    {
+        std::lock_guard deviceLock(m_DeviceMutex);
+        std::lock_guard lock(m_Mutex);
+
+        if (!m_DecompressorFactory)
+        {
+            return CE::ZCE_ERROR;
+        }
+
+        FileEntry* entry = FindLeasedEntry(lease);
+        if (!entry)
+        {
+            assert(0);
+            return CE::ZCE_ERROR;
+        }
+        return GetOrCreateDecompressor(*entry, memoryLimitPerResource, outLease);
+    }
+
+    void DecompressorPool::ReleaseDecompressor(const DecompressorLease& lease) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        FileEntry* entry = FindLeasedEntry(lease);
+        if (!entry)
+        {
+            assert(0);
+            return;
+        }
+        entry->isLeased = false;
+        entry->lastReleaseTime = Clock::now();
+    }
+
+    CE::ReturnCode DecompressorPool::GetOrCreateDecompressor(FileEntry& entry, size_t memoryLimitPerResource,
+                                                             DecompressorLease* outLease) noexcept
+    {
+        auto decompressorIt = entry.decompressors.find(memoryLimitPerResource);
+        if (decompressorIt != entry.decompressors.end())
+        {
+            *outLease = decompressorIt->second;
+            return CE::ZCE_SUCCESS;
+        }
+
+        DecompressorLease lease{};
+        lease.decoder = entry.decoder;
+
+        // Factory is shared, so its whole configuration is applied for every decompressor it creates.
+        auto status = m_DecompressorFactory->SetMemoryLimitPerResource(memoryLimitPerResource);
+        if (status == CE::ZCE_SUCCESS)
+        {
+            status = m_DecompressorFactory->UseDecoder(entry.decoder);
+        }
+        if (status == CE::ZCE_SUCCESS)
+        {
+            status = m_DecompressorFactory->Create(&lease.decompressor);
+        }
+        if (status == CE::ZCE_SUCCESS)
+        {
+            status = lease.decompressor->Initialize();
+        }
+        if (status == CE::ZCE_SUCCESS)
+        {
+            lease.formatMapper = lease.decompressor->GetFormatMapper();
+            if (!lease.formatMapper)
+            {
+                status = CE::ZCE_ERROR;
+            }
+        }
+        if (status != CE::ZCE_SUCCESS)
+        {
+            if (lease.decompressor)
+            {
+                lease.decompressor->Release();
+            }
+            return status;
+        }
+
+        entry.decompressors.emplace(memoryLimitPerResource, lease);
+        *outLease = lease;
+        return CE::ZCE_SUCCESS;
+    }
+
+    DecompressorPool::FileEntry* DecompressorPool::FindLeasedEntry(const DecompressorLease& lease) noexcept
+    {
+        for (auto& [key, entry] : m_Files)
+        {
+            if (entry.isLeased && entry.decoder == lease.decoder)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    CE::ReturnCode DecompressorPool::AcquireBuffer(size_t sizeInBytes, size_t stride, RHI::Buffer** outBuffer) noexcept
+    {
+        std::lock_guard deviceLock(m_DeviceMutex);
+        std::lock_guard lock(m_Mutex);
+
+        if (!m_RHIRuntime)
+        {
+            return CE::ZCE_ERROR;
+        }
+
+        ReclaimIdleObjects(false);
+
+        const BufferKey key{sizeInBytes, stride};
+        auto idleIt = m_IdleBuffers.find(key);
+        if (idleIt != m_IdleBuffers.end())
+        {
+            *outBuffer = idleIt->second.buffer;
+            m_IdleBuffers.erase(idleIt);
+            m_LeasedBuffers.emplace(*outBuffer, key);
+            return CE::ZCE_SUCCESS;
+        }
+
+        RHI::Buffer* buffer = nullptr;
+        auto RHIstatus = m_RHIRuntime->CreateBuffer(
+            sizeInBytes, RHI::ResourceHeapType::Default,
+            RHI::ResourceUsage::UnorderedAccess | RHI::ResourceUsage::ShaderResource | RHI::ResourceUsage::CopySource,
+            static_cast<uint32_t>(stride), "decompressionExternalBuffer", &buffer);
+        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        {
+            return CE::ZCE_ERROR;
+        }
+
+        m_LeasedBuffers.emplace(buffer, key);
+        *outBuffer = buffer;
+        return CE::ZCE_SUCCESS;
+    }
+
+    void DecompressorPool::ReleaseBuffer(RHI::Buffer* buffer) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        auto leasedIt = m_LeasedBuffers.find(buffer);
+        if (leasedIt == m_LeasedBuffers.end())
+        {
+            assert(0);
+            return;
+        }
+
+        m_IdleBuffers.emplace(leasedIt->second, IdleBuffer{buffer, Clock::now()});
+        m_LeasedBuffers.erase(leasedIt);
+    }
+
+    std::recursive_mutex& DecompressorPool::GetDeviceMutex() noexcept
+    {
+        return m_DeviceMutex;
+    }
+
+    CE::ReturnCode DecompressorPool::InitializeRuntime() noexcept
+    {
+        RHI::RHIFactory* RHIFactory = nullptr;
+        auto RHIstatus = RHI::CAPI::CreateRHIFactory(&RHIFactory);
+        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        {
+            return CE::ZCE_ERROR;
+        }
+
+        RHIstatus = RHIFactory->SetGFXAPI(Helpers::SelectGFXAPI());
+        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        {
+            RHIFactory->Release();
+            return CE::ZCE_ERROR;
+        }
+
+        if (Helpers::NeedForceSoftwareDevice())
+        {
+            RHIstatus = RHIFactory->ForceSoftwareDevice();
+            if (RHIstatus != RHI::ZRHI_SUCCESS)
+            {
+                RHIFactory->Release();
+                return CE::ZCE_ERROR;
+            }
+        }
+
+        RHIstatus = RHIFactory->Create(&m_RHIRuntime);
+        RHIFactory->Release();
+        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        {
+            return CE::ZCE_ERROR;
+        }
+
+        RHIstatus = m_RHIRuntime->Initialize();
+        if (RHIstatus != RHI::ZRHI_SUCCESS)
+        {
+            m_RHIRuntime->Release();
+            m_RHIRuntime = nullptr;
+            return CE::ZCE_ERROR;
+        }
+
+        auto status = CE::Decompression::CAPI::CreateDecompressorFactory(&m_DecompressorFactory);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            m_RHIRuntime->Release();
+            m_RHIRuntime = nullptr;
+            return status;
+        }
+
+        status = m_DecompressorFactory->UseRHI(m_RHIRuntime);
+        if (status != CE::ZCE_SUCCESS)
+        {
+            m_DecompressorFactory->Release();
+            m_DecompressorFactory = nullptr;
+            m_RHIRuntime->Release();
+            m_RHIRuntime = nullptr;
+            return status;
+        }
+
+        return CE::ZCE_SUCCESS;
+    }
+
+    void DecompressorPool::ReclaimIdleObjects(bool forceAll) noexcept
+    {
+        const Clock::time_point now = Clock::now();
+        auto isExpired = [&](Clock::time_point lastReleaseTime) { return forceAll || now - lastReleaseTime >= IDLE_RECLAIM_TIMEOUT; };
+
+        for (auto it = m_Files.begin(); it != m_Files.end();)
+        {
+            if (!it->second.isLeased && isExpired(it->second.lastReleaseTime))
+            {
+                ReleaseFileEntry(it->second);
+                it = m_Files.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (auto it = m_IdleBuffers.begin(); it != m_IdleBuffers.end();)
+        {
+            if (isExpired(it->second.lastReleaseTime))
+            {
+                m_RHIRuntime->ReleaseBuffer(it->second.buffer);
+                it = m_IdleBuffers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void DecompressorPool::StartReclaimThread() noexcept
+    {
+        std::lock_guard lock(m_ReclaimMutex);
+        if (!m_IsExitCallbackRegistered)
+        {
+            UT_Exit::addExitCallback([](void*) { DecompressorPool::GetInstance().StopReclaimThread(); }, nullptr);
+            m_IsExitCallbackRegistered = true;
+        }
+        if (m_ReclaimThread.joinable())
+        {
+            return;
+        }
+        m_ReclaimThread = std::thread(&DecompressorPool::ReclaimThreadLoop, this, m_ReclaimGeneration);
+    }
+
+    std::thread DecompressorPool::TakeReclaimThread() noexcept
+    {
+        std::thread reclaimThread;
+        {
+            std::lock_guard lock(m_ReclaimMutex);
+            ++m_ReclaimGeneration;
+            reclaimThread = std::move(m_ReclaimThread);
+        }
+        m_ReclaimWakeup.notify_all();
+        return reclaimThread;
+    }
+
+    void DecompressorPool::StopReclaimThread() noexcept
+    {
+        std::thread reclaimThread = TakeReclaimThread();
+        if (reclaimThread.joinable())
+        {
+            reclaimThread.join();
+        }
+    }
+
+    void DecompressorPool::ReclaimThreadLoop(size_t generation) noexcept
+    {
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_ReclaimMutex);
+                if (m_ReclaimWakeup.wait_for(lock, IDLE_RECLAIM_INTERVAL, [&] { return m_ReclaimGeneration != generation; }))
+                {
+                    return;
+                }
+            }
+
+            std::lock_guard deviceLock(m_DeviceMutex);
+            std::lock_guard lock(m_Mutex);
+            // Runtime may be released between wakeup and taking locks, in which case everything is reclaimed already.
+            if (m_RuntimeRefCount != 0)
+            {
+                ReclaimIdleObjects(false);
+            }
+        }
+    }
+
+    void DecompressorPool::ReleaseFileEntry(FileEntry& entry) noexcept
+    {
+        // Format mappers and decompressors are released before decoder they were created with
+        for (auto& [memoryLimitPerResource, lease] : entry.decompressors)
+        {
+            lease.formatMapper->Release();
+            lease.decompressor->Release();
+        }
+        entry.decompressors.clear();
+        if (entry.decoder)
+        {
+            CE::Decompression::CAPI::ReleaseDecoder(entry.decoder);
+            entry.decoder = nullptr;
+        }
+    }
+} // namespace Zibra::Helpers
@@ -0,0 +1,91 @@
+#include "PrecompiledHeader.h"
+
+#include "utils/FrameMetadataSnapshot.h"
+
+namespace Zibra::Helpers
+{
+    FrameMetadataSnapshot* FrameMetadataSnapshot::Create(const CE::Decompression::CompressedFrameContainer* frameContainer) noexcept
+    {
+        auto* snapshot = new FrameMetadataSnapshot();
+        snapshot->m_Info = frameContainer->GetInfo();
+        snapshot->m_ChannelNames.reserve(snapshot->m_Info.channelsCount);
+        for (size_t i = 0; i < snapshot->m_Info.channelsCount; ++i)
+        {
+            const char* name = snapshot->m_Info.channels[i].name;
+            snapshot->m_ChannelNames.emplace_back(name ? name : "");
+        }
+        snapshot->BindChannelNames();
+
+        const size_t metadataCount = frameContainer->GetMetadataCount();
+        snapshot->m_Metadata.reserve(metadataCount);
+        for (size_t i = 0; i < metadataCount; ++i)
+        {
+            CE::MetadataEntry entry{};
+            if (frameContainer->GetMetadataByIndex(i, &entry) != CE::ZCE_SUCCESS || !entry.key)
+            {
+                continue;
+            }
+            snapshot->m_Metadata.emplace_back(entry.key, entry.value ? entry.value : "");
+        }
+        return snapshot;
+    }
+
+    FrameMetadataSnapshot::FrameMetadataSnapshot(const FrameMetadataSnapshot& other) noexcept
+        : m_Info(other.m_Info)
+        , m_ChannelNames(other.m_ChannelNames)
+        , m_Metadata(other.m_Metadata)
+    {
+        BindChannelNames();
+    }
+
+    FrameMetadataSnapshot* FrameMetadataSnapshot::Clone() const noexcept
+    {
+        return new FrameMetadataSnapshot(*this);
+    }
+
+    CE::Decompression::FrameInfo FrameMetadataSnapshot::GetInfo() const noexcept
+    {
+        return m_Info;
+    }
+
+    const char* FrameMetadataSnapshot::GetMetadataByKey(const char* key) const noexcept
+    {
+        for (const auto& [entryKey, entryValue] : m_Metadata)
+        {
+            if (entryKey == key)
+            {
+                return entryValue.c_str();
+            }
+        }
+        return nullptr;
+    }
+
+    size_t FrameMetadataSnapshot::GetMetadataCount() const noexcept
+    {
+        return m_Metadata.size();
+    }
+
+    CE::ReturnCode FrameMetadataSnapshot::GetMetadataByIndex(size_t index, CE::MetadataEntry* outEntry) const noexcept
+    {
+        if (index >= m_Metadata.size())
+        {
+            return CE::ZCE_ERROR_INVALID_ARGUMENTS;
+        }
+        outEntry->key = m_Metadata[index].first.c_str();
+        outEntry->value = m_Metadata[index].second.c_str();
+        return CE::ZCE_SUCCESS;
+    }
+
+    void FrameMetadataSnapshot::Release() noexcept
+    {
+        delete this;
+    }
+
+    void FrameMetadataSnapshot::BindChannelNames() noexcept
+    {
+        for (size_t i = 0; i < m_ChannelNames.size(); ++i)
+        {
+            m_Info.channels[i].name = m_ChannelNames[i].c_str();
+        }
+    }
+} // namespace Zibra::Helpers
@@ -147,9 +147,9 @@ namespace Zibra::Helpers
         return result;
     }
 
-    bool NeedForceSoftwareDevice()
+    static bool IsEnvironmentVariableEnabled(const char* envVarName)
     {
-        std::optional<std::string> envVar = GetNormalEnvironmentVariable("ZIBRAVDB_FOR_HOUDINI_FORCE_SOFTWARE_DEVICE");
+        std::optional<std::string> envVar = GetNormalEnvironmentVariable(envVarName);
         if (!envVar.has_value())
         {
             return false;
@@ -164,6 +164,68 @@ namespace Zibra::Helpers
         return false;
     }
 
+    bool NeedForceSoftwareDevice()
+    {
+        return IsEnvironmentVariableEnabled("ZIBRAVDB_FOR_HOUDINI_FORCE_SOFTWARE_DEVICE");
+    }
+
+    bool NeedSerialDecompression()
+    {
+        return IsEnvironmentVariableEnabled("ZIBRAVDB_FOR_HOUDINI_SERIAL_DECOMPRESSION");
+    }
+
+    size_t GetDecompressionMemoryLimitOverride()
+    {
+        std::optional<std::string> envVar = GetNormalEnvironmentVariable("ZIBRAVDB_FOR_HOUDINI_DECOMPRESSION_MEMORY_LIMIT_MB");
+        int limitMB = 0;
+        if (!envVar.has_value() || !TryParseInt(envVar.value(), limitMB) || limitMB <= 0)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(limitMB) * 1024 * 1024;
+    }
+
+    std::optional<std::string> GetDecodeTimingsLogPath()
+    {
+        std::optional<std::string> envVar = GetNormalEnvironmentVariable("ZIBRAVDB_FOR_HOUDINI_DECODE_TIMINGS_LOG");
+        if (!envVar.has_value() || envVar->empty())
+        {
+            return std::nullopt;
+        }
+        return envVar;
+    }
+
+    uint64_t GetPhysicalMemorySize()
+    {
+#if ZIB_TARGET_OS_WIN
+        MEMORYSTATUSEX memoryStatus{};
+        memoryStatus.dwLength = sizeof(memoryStatus);
+        if (!::GlobalMemoryStatusEx(&memoryStatus))
+        {
+            return 0;
+        }
+        return memoryStatus.ullTotalPhys;
+#elif ZIB_TARGET_OS_LINUX
+        const long pageCount = sysconf(_SC_PHYS_PAGES);
+        const long pageSize = sysconf(_SC_PAGE_SIZE);
+        if (pageCount <= 0 || pageSize <= 0)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(pageCount) * static_cast<uint64_t>(pageSize);
+#elif ZIB_TARGET_OS_MAC
+        uint64_t memorySize = 0;
+        size_t valueSize = sizeof(memorySize);
+        if (sysctlbyname("hw.memsize", &memorySize, &valueSize, nullptr, 0) != 0)
+        {
+            return 0;
+        }
+        return memorySize;
+#else
+#error Unexpected OS
+#endif
+    }
+
     std::map<std::string, std::string> ParseQueryParamsString(const std::string& queryString)
     {
         std::map<std::string, std::string> result;
@@ -0,0 +1,110 @@
+#include "PrecompiledHeader.h"
+
+#include "utils/SpatialBlockIndex.h"
+
+namespace Zibra::Helpers
+{
+    SpatialBlockIndex& SpatialBlockIndex::GetInstance() noexcept
+    {
+        static SpatialBlockIndex instance;
+        return instance;
+    }
+
+    bool SpatialBlockIndex::Find(const Key& key, std::vector<BlockBounds>* outGroupBounds) const noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        auto keyIt = m_GroupBoundsByKey.find(key);
+        if (keyIt == m_GroupBoundsByKey.end())
+        {
+            return false;
+        }
+        *outGroupBounds = keyIt->second;
+        return true;
+    }
+
+    bool SpatialBlockIndex::Contains(const Key& key) const noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+        return m_GroupBoundsByKey.find(key) != m_GroupBoundsByKey.end();
+    }
+
+    void SpatialBlockIndex::Insert(const Key& key, std::vector<BlockBounds> groupBounds) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        if (m_GroupBoundsByKey.find(key) != m_GroupBoundsByKey.end())
+        {
+            return;
+        }
+
+        while (m_InsertionOrder.size() >= MAX_INDEXED_FRAMES)
+        {
+            m_GroupBoundsByKey.erase(m_InsertionOrder.front());
+            m_InsertionOrder.pop_front();
+        }
+
+        m_GroupBoundsByKey.emplace(key, std::move(groupBounds));
+        m_InsertionOrder.push_back(key);
+    }
+
+    void SpatialBlockIndex::Erase(const Key& key) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        if (m_GroupBoundsByKey.erase(key) == 0)
+        {
+            return;
+        }
+        auto isSameKey = [&](const Key& other) { return !(other < key) && !(key < other); };
+        auto orderIt = std::find_if(m_InsertionOrder.begin(), m_InsertionOrder.end(), isSameKey);
+        if (orderIt != m_InsertionOrder.end())
+        {
+            m_InsertionOrder.erase(orderIt);
+        }
+    }
+
+    std::vector<BlockBounds> SpatialBlockIndex::BuildGroupBounds(const CE::SpatialBlockInfo* spatialInfo, size_t spatialInfoCount) noexcept
+    {
+        std::vector<BlockBounds> result((spatialInfoCount + GROUP_SIZE - 1) / GROUP_SIZE);
+        for (size_t i = 0; i < spatialInfoCount; ++i)
+        {
+            result[i / GROUP_SIZE].Extend(spatialInfo[i].coords);
+        }
+        return result;
+    }
+
+    std::string SpatialBlockIndex::Serialize(const std::vector<BlockBounds>& groupBounds, size_t spatialBlockCount) noexcept
+    {
+        std::ostringstream oss;
+        oss << GROUP_SIZE << ' ' << spatialBlockCount;
+        for (const BlockBounds& bounds : groupBounds)
+        {
+            oss << ' ' << bounds.min[0] << ' ' << bounds.min[1] << ' ' << bounds.min[2];
+            oss << ' ' << bounds.max[0] << ' ' << bounds.max[1] << ' ' << bounds.max[2];
+        }
+        return oss.str();
+    }
+
+    bool SpatialBlockIndex::Deserialize(const char* serialized, size_t spatialBlockCount, std::vector<BlockBounds>* outGroupBounds) noexcept
+    {
+        std::istringstream iss(serialized);
+        uint32_t groupSize = 0;
+        size_t storedSpatialBlockCount = 0;
+        if (!(iss >> groupSize >> storedSpatialBlockCount) || groupSize != GROUP_SIZE || storedSpatialBlockCount != spatialBlockCount)
+        {
+            return false;
+        }
+
+        std::vector<BlockBounds> result((spatialBlockCount + GROUP_SIZE - 1) / GROUP_SIZE);
+        for (BlockBounds& bounds : result)
+        {
+            if (!(iss >> bounds.min[0] >> bounds.min[1] >> bounds.min[2] >> bounds.max[0] >> bounds.max[1] >> bounds.max[2]))
+            {
+                return false;
+            }
+        }
+        *outGroupBounds = std::move(result);
+        return true;
+    }
+} // namespace Zibra::Helpers
@@ -234,6 +234,25 @@ namespace Zibra::ZibraVDBCompressor
                                   &thePerChannelCompressionSettingsName[0], nullptr, nullptr, nullptr, nullptr,
                                   &thePerChannelCompressionSettingsNameCondition);
 
+        static PRM_Name theCullBackgroundBlocksName(CULL_BACKGROUND_BLOCKS_PARAM_NAME, "Skip Background Blocks");
+        static PRM_Default theCullBackgroundBlocksDefault(0);
+        static PRM_Name theCullBackgroundToleranceName(CULL_BACKGROUND_TOLERANCE_PARAM_NAME, "Background Tolerance");
+        static PRM_Default theCullBackgroundToleranceDefault(0.0f);
+        static PRM_Range theCullBackgroundToleranceRange(PRM_RANGE_RESTRICTED, 0.0f, PRM_RANGE_UI, 1.0f);
+        static PRM_Conditional theCullBackgroundToleranceCondition("{ cullbackground == \"off\" }", PRM_CONDTYPE_DISABLE);
+        static const char* theCullBackgroundBlocksHelp =
+            "Skips leaf blocks whose voxels all match grid background. "
+            "Voxels of skipped blocks become inactive background after decompression, even if they were active.";
+        static const char* theCullBackgroundToleranceHelp =
+            "Largest absolute difference from grid background, in grid value units, for voxel to count as background. "
+            "Each component of vector values is compared separately. Slider range is for convenience, larger values are allowed.";
+
+        templateList.emplace_back(PRM_TOGGLE, 1, &theCullBackgroundBlocksName, &theCullBackgroundBlocksDefault, nullptr, nullptr, nullptr,
+                                  nullptr, 1, theCullBackgroundBlocksHelp);
+        templateList.emplace_back(PRM_FLT, 1, &theCullBackgroundToleranceName, &theCullBackgroundToleranceDefault, nullptr,
+                                  &theCullBackgroundToleranceRange, nullptr, nullptr, 1, theCullBackgroundToleranceHelp,
+                                  &theCullBackgroundToleranceCondition);
+
         templateList.push_back(theRopTemplates[ROP_TPRERENDER_TPLATE]);
         templateList.push_back(theRopTemplates[ROP_PRERENDER_TPLATE]);
         templateList.push_back(theRopTemplates[ROP_LPRERENDER_TPLATE]);
@@ -553,8 +572,14 @@ namespace Zibra::ZibraVDBCompressor
         CE::Compression::FrameManager* frameManager = nullptr;
 
         CE::Addons::OpenVDBUtils::FrameLoader vdbFrameLoader{volumes.data(), volumes.size()};
+        // Blocks that only hold background are dropped before compression, so they don't cost compression time and file size.
+        CE::Addons::OpenVDBUtils::BlockCullingOptions cullingOptions{};
+        cullingOptions.cullBackgroundBlocks = evalInt(CULL_BACKGROUND_BLOCKS_PARAM_NAME, 0, time) != 0;
+        cullingOptions.backgroundTolerance = static_cast<float>(evalFloat(CULL_BACKGROUND_TOLERANCE_PARAM_NAME, 0, time));
+        vdbFrameLoader.SetCullingOptions(cullingOptions);
         CE::Addons::OpenVDBUtils::EncodingMetadata encodingMetadata{};
-        compressFrameDesc.frame = vdbFrameLoader.LoadFrame(&encodingMetadata);
+        // Frame buffers are owned by arena and reused for next frames, so frame is not released here.
+        compressFrameDesc.frame = vdbFrameLoader.LoadFrame(&encodingMetadata, &m_FrameArena);
         const auto& gridsShuffleInfo = vdbFrameLoader.GetGridsShuffleInfo();
 
         auto status = m_CompressorManager.CompressFrame(compressFrameDesc, &frameManager);
@@ -613,10 +638,14 @@ namespace Zibra::ZibraVDBCompressor
             return ROP_ABORT_RENDER;
         }
 
-        vdbFrameLoader.ReleaseFrame(compressFrameDesc.frame);
-
         auto frameMetadata = Utils::MetadataHelper::DumpAttributes(gdp, encodingMetadata);
         frameMetadata.push_back({"chShuffle", Utils::MetadataHelper::DumpGridsShuffleInfo(gridsShuffleInfo).dump()});
+        // Lets region of interest decompression skip spatial blocks before the frame is decompressed for the first time.
+        const CE::Compression::SparseFrame* sparseFrame = compressFrameDesc.frame;
+        frameMetadata.push_back({Helpers::SpatialBlockIndex::METADATA_KEY,
+                                 Helpers::SpatialBlockIndex::Serialize(
+                                     Helpers::SpatialBlockIndex::BuildGroupBounds(sparseFrame->spatialInfo, sparseFrame->spatialInfoCount),
+                                     sparseFrame->spatialInfoCount)});
         for (const auto& [key, val] : frameMetadata)
         {
             frameManager->AddMetadata(key.c_str(), val.c_str());
@@ -661,6 +690,7 @@ namespace Zibra::ZibraVDBCompressor
         }
 
         m_CompressorManager.Release();
+        m_FrameArena.Release();
 
         if (error() < UT_ERROR_ABORT)
         {
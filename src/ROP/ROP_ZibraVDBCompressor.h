@@ -46,6 +46,8 @@ namespace Zibra::ZibraVDBCompressor
         static constexpr const char* PER_CHANNEL_COMPRESSION_SETTINGS_CHANNEL_NAME_PARAM_NAME = "perchname";
         static constexpr const char* PER_CHANNEL_COMPRESSION_SETTINGS_QUALITY_PARAM_NAME = "perchquality";
         static constexpr const char* FILENAME_PARAM_NAME = "filename";
+        static constexpr const char* CULL_BACKGROUND_BLOCKS_PARAM_NAME = "cullbackground";
+        static constexpr const char* CULL_BACKGROUND_TOLERANCE_PARAM_NAME = "cullbackgroundtolerance";
         static constexpr const char* OPEN_PLUGIN_MANAGEMENT_BUTTON_NAME = "openmanagement";
         static constexpr const char* CORE_LIB_PATH_FIELD_NAME = "corelibpath";
 
@@ -84,6 +86,8 @@ namespace Zibra::ZibraVDBCompressor
         ContextType m_ContextType;
 
         CE::Compression::CompressorManager m_CompressorManager;
+        // Buffers of compressed frames, reused between frames of one render and freed in endRender.
+        CE::Addons::FrameArena m_FrameArena;
         
         UT_String m_OutputFileName;
         bool m_OutputFileInconsistentWarningShown = false;
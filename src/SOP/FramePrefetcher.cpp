@@ -0,0 +1,203 @@
+#include "PrecompiledHeader.h"
+
+#include "FramePrefetcher.h"
+
+namespace Zibra::ZibraVDBDecompressor
+{
+    FramePrefetcher::~FramePrefetcher() noexcept
+    {
+        Reset();
+        // Same as in SOP destructor, decompressor can't be released once library is unloaded.
+        if (!LibraryUtils::IsLibraryLoaded())
+        {
+            return;
+        }
+        m_DecompressorManager.Release();
+    }
+
+    void FramePrefetcher::Prefetch(const std::string& filename, const Helpers::FrameDecodeOptions& options, exint currentFrame,
+                                   int direction, int count, const CE::Decompression::FrameRange& frameRange) noexcept
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+
+            if (filename != m_Filename || options != m_Options)
+            {
+                for (auto& [frameIndex, frame] : m_ReadyFrames)
+                {
+                    ReleaseFrame(frame);
+                }
+                m_ReadyFrames.clear();
+                m_Filename = filename;
+                m_Options = options;
+            }
+
+            const exint windowEndFrame = currentFrame + exint(direction) * count;
+            m_WindowFirstFrame = std::max<exint>(std::min(currentFrame + direction, windowEndFrame), frameRange.start);
+            m_WindowLastFrame = std::min<exint>(std::max(currentFrame + direction, windowEndFrame), frameRange.end);
+
+            for (auto it = m_ReadyFrames.begin(); it != m_ReadyFrames.end();)
+            {
+                if (!IsFrameRequested(it->first))
+                {
+                    ReleaseFrame(it->second);
+                    it = m_ReadyFrames.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            // Nearest frames are decompressed first
+            m_PendingFrames.clear();
+            for (int i = 1; i <= count; ++i)
+            {
+                const exint frameIndex = currentFrame + exint(direction) * i;
+                if (!IsFrameRequested(frameIndex) || m_ReadyFrames.find(frameIndex) != m_ReadyFrames.end() ||
+                    m_InFlightFrame == frameIndex)
+                {
+                    continue;
+                }
+                m_PendingFrames.push_back(frameIndex);
+            }
+
+            if (!m_Worker.joinable())
+            {
+                m_IsStopping = false;
+                m_Worker = std::thread(&FramePrefetcher::WorkerLoop, this);
+            }
+        }
+        m_RequestsChanged.notify_one();
+    }
+
+    bool FramePrefetcher::TryTakeFrame(const std::string& filename, const Helpers::FrameDecodeOptions& options, exint frameIndex,
+                                       PrefetchedFrame& outFrame) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+
+        if (filename != m_Filename || options != m_Options)
+        {
+            return false;
+        }
+
+        auto readyIt = m_ReadyFrames.find(frameIndex);
+        if (readyIt == m_ReadyFrames.end())
+        {
+            return false;
+        }
+        outFrame = std::move(readyIt->second);
+        m_ReadyFrames.erase(readyIt);
+        return true;
+    }
+
+    void FramePrefetcher::Reset() noexcept
+    {
+        if (m_Worker.joinable())
+        {
+            {
+                std::lock_guard lock(m_Mutex);
+                m_IsStopping = true;
+            }
+            m_RequestsChanged.notify_one();
+            m_Worker.join();
+        }
+
+        std::lock_guard lock(m_Mutex);
+        for (auto& [frameIndex, frame] : m_ReadyFrames)
+        {
+            ReleaseFrame(frame);
+        }
+        m_ReadyFrames.clear();
+        m_PendingFrames.clear();
+        m_Filename.clear();
+        m_Options = {};
+        m_WindowFirstFrame = 0;
+        m_WindowLastFrame = -1;
+        // File may have been changed on disk, so decompressor must be registered again
+        m_RegisteredFilename.clear();
+        m_IsStopping = false;
+    }
+
+    void FramePrefetcher::SetMemoryLimitPerResource(size_t limitInBytes) noexcept
+    {
+        std::lock_guard lock(m_Mutex);
+        m_MemoryLimitPerResource = limitInBytes;
+    }
+
+    void FramePrefetcher::WorkerLoop() noexcept
+    {
+        while (true)
+        {
+            exint frameIndex = 0;
+            std::string filename;
+            Helpers::FrameDecodeOptions options;
+            size_t memoryLimitPerResource = 0;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_RequestsChanged.wait(lock, [this] { return !m_PendingFrames.empty() || m_IsStopping; });
+                if (m_IsStopping)
+                {
+                    return;
+                }
+                frameIndex = m_PendingFrames.front();
+                m_PendingFrames.pop_front();
+                m_InFlightFrame = frameIndex;
+                filename = m_Filename;
+                options = m_Options;
+                memoryLimitPerResource = m_MemoryLimitPerResource;
+            }
+
+            bool isDecompressed = false;
+            PrefetchedFrame frame{};
+            if (filename != m_RegisteredFilename)
+            {
+                m_RegisteredFilename.clear();
+                if (m_DecompressorManager.Initialize() == CE::ZCE_SUCCESS &&
+                    m_DecompressorManager.RegisterDecompressor(filename.c_str()) == CE::ZCE_SUCCESS)
+                {
+                    m_RegisteredFilename = filename;
+                }
+            }
+            if (!m_RegisteredFilename.empty())
+            {
+                m_DecompressorManager.SetMemoryLimitPerResource(memoryLimitPerResource);
+                isDecompressed = DecompressFrame(frameIndex, options, frame);
+            }
+
+            std::lock_guard lock(m_Mutex);
+            m_InFlightFrame.reset();
+            const bool isStillRequested = filename == m_Filename && options == m_Options && IsFrameRequested(frameIndex);
+            if (isDecompressed && isStillRequested && m_ReadyFrames.find(frameIndex) == m_ReadyFrames.end())
+            {
+                m_ReadyFrames.emplace(frameIndex, std::move(frame));
+            }
+            else
+            {
+                ReleaseFrame(frame);
+            }
+        }
+    }
+
+    bool FramePrefetcher::DecompressFrame(exint frameIndex, const Helpers::FrameDecodeOptions& options, PrefetchedFrame& outFrame) noexcept
+    {
+        // Original frame container is released by the manager right after decompression, on this thread.
+        auto status = m_DecompressorManager.DecompressFrameCached(frameIndex, options, &outFrame.grids, &outFrame.frameContainer);
+        return status == CE::ZCE_SUCCESS;
+    }
+
+    bool FramePrefetcher::IsFrameRequested(exint frameIndex) const noexcept
+    {
+        return frameIndex >= m_WindowFirstFrame && frameIndex <= m_WindowLastFrame;
+    }
+
+    void FramePrefetcher::ReleaseFrame(PrefetchedFrame& frame) noexcept
+    {
+        if (frame.frameContainer)
+        {
+            frame.frameContainer->Release();
+            frame.frameContainer = nullptr;
+        }
+        frame.grids.clear();
+    }
+} // namespace Zibra::ZibraVDBDecompressor
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "utils/DecompressorManager.h"
+
+namespace Zibra::ZibraVDBDecompressor
+{
+    // Decompresses frames that are expected to be cooked next on background thread,
+    // so during playback cook only needs to build primitives from already decompressed grids.
+    class FramePrefetcher
+    {
+    public:
+        struct PrefetchedFrame
+        {
+            openvdb::GridPtrVec grids;
+            // Snapshot of frame metadata, ownership is passed to the caller of TryTakeFrame.
+            // Original frame container is released on worker thread, since it's only valid while format mapper
+            // of the prefetcher's decompressor lease is alive.
+            CE::Decompression::CompressedFrameContainer* frameContainer = nullptr;
+        };
+
+    public:
+        ~FramePrefetcher() noexcept;
+
+        // Requests frames currentFrame + direction * [1..count] of the file to be decompressed in background.
+        // Pending and ready frames outside of this window are dropped.
+        void Prefetch(const std::string& filename, const Helpers::FrameDecodeOptions& options, exint currentFrame, int direction, int count,
+                      const CE::Decompression::FrameRange& frameRange) noexcept;
+        // Returns true and moves frame out of ready queue if it was already decompressed with the same options.
+        bool TryTakeFrame(const std::string& filename, const Helpers::FrameDecodeOptions& options, exint frameIndex,
+                          PrefetchedFrame& outFrame) noexcept;
+        // Stops background thread and drops all prefetched frames.
+        void Reset() noexcept;
+        // Forwarded to DecompressorManager used by background thread, 0 means automatic limit.
+        void SetMemoryLimitPerResource(size_t limitInBytes) noexcept;
+
+    private:
+        void WorkerLoop() noexcept;
+        bool DecompressFrame(exint frameIndex, const Helpers::FrameDecodeOptions& options, PrefetchedFrame& outFrame) noexcept;
+        bool IsFrameRequested(exint frameIndex) const noexcept;
+        static void ReleaseFrame(PrefetchedFrame& frame) noexcept;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_RequestsChanged;
+        std::thread m_Worker;
+        bool m_IsStopping = false;
+
+        std::string m_Filename;
+        Helpers::FrameDecodeOptions m_Options;
+        size_t m_MemoryLimitPerResource = 0;
+        exint m_WindowFirstFrame = 0;
+        exint m_WindowLastFrame = -1;
+        std::deque<exint> m_PendingFrames;
+        std::optional<exint> m_InFlightFrame;
+        std::map<exint, PrefetchedFrame> m_ReadyFrames;
+
+        // Only accessed from worker thread
+        Helpers::DecompressorManager m_DecompressorManager;
+        std::string m_RegisteredFilename;
+    };
+} // namespace Zibra::ZibraVDBDecompressor
@@ -20,19 +20,93 @@ namespace Zibra::ZibraVDBDecompressor
         static PRM_Name theFrameName(FRAME_PARAM_NAME, "Sequence Frame");
         static PRM_Default theFrameDefault(0, "$F");
 
+        static PRM_Name theChannelsName(CHANNELS_PARAM_NAME, "Channels");
+        static PRM_Default theChannelsDefault(0.0f, "*");
+        static PRM_ChoiceList theChannelsChoiceList(PRM_CHOICELIST_TOGGLE, &SOP_ZibraVDBDecompressor::BuildChannelsChoiceList);
+
+        static PRM_Name theUseROIName(USE_ROI_PARAM_NAME, "Limit to Region of Interest");
+        static PRM_Default theUseROIDefault(0);
+        static PRM_Conditional theROICondition("{ useroi == \"off\" }", PRM_CONDTYPE_DISABLE);
+
+        static PRM_Name theROISpaceName(ROI_SPACE_PARAM_NAME, "Region Space");
+        static PRM_Default theROISpaceDefault(0, "world");
+        static PRM_Name theROISpaceChoices[] = {PRM_Name("world", "World Space"), PRM_Name("index", "Index Space"), PRM_Name(0, 0)};
+        static PRM_ChoiceList theROISpaceChoiceList(PRM_CHOICELIST_SINGLE, theROISpaceChoices);
+
+        static PRM_Name theROIMinName(ROI_MIN_PARAM_NAME, "Region Min");
+        static PRM_Default theROIMinDefault[] = {PRM_Default(-1), PRM_Default(-1), PRM_Default(-1)};
+        static PRM_Name theROIMaxName(ROI_MAX_PARAM_NAME, "Region Max");
+        static PRM_Default theROIMaxDefault[] = {PRM_Default(1), PRM_Default(1), PRM_Default(1)};
+
+        static PRM_Name theDeactivateBackgroundName(DEACTIVATE_BACKGROUND_PARAM_NAME, "Deactivate Background Voxels");
+        static PRM_Default theDeactivateBackgroundDefault(0);
+        static PRM_Name theBackgroundToleranceName(BACKGROUND_TOLERANCE_PARAM_NAME, "Background Tolerance");
+        static PRM_Default theBackgroundToleranceDefault(0.0f);
+        static PRM_Range theBackgroundToleranceRange(PRM_RANGE_RESTRICTED, 0.0f, PRM_RANGE_UI, 1.0f);
+        static PRM_Conditional theBackgroundToleranceCondition("{ deactivatebackground == \"off\" }", PRM_CONDTYPE_DISABLE);
+
+        static PRM_Name theCollapseUniformName(COLLAPSE_UNIFORM_PARAM_NAME, "Collapse Uniform Blocks to Tiles");
+        static PRM_Default theCollapseUniformDefault(0);
+        static PRM_Name theUniformToleranceName(UNIFORM_TOLERANCE_PARAM_NAME, "Uniform Tolerance");
+        static PRM_Default theUniformToleranceDefault(0.0f);
+        static PRM_Range theUniformToleranceRange(PRM_RANGE_RESTRICTED, 0.0f, PRM_RANGE_UI, 1.0f);
+        static PRM_Conditional theUniformToleranceCondition("{ collapseuniform == \"off\" }", PRM_CONDTYPE_DISABLE);
+
+        // Houdini VDB primitives don't support half grids, so 16 bit precision is only applied when grids are saved
+        static PRM_Name thePrecisionName(PRECISION_PARAM_NAME, "Output Precision");
+        static PRM_Default thePrecisionDefault(0, "float32");
+        static PRM_Name thePrecisionChoices[] = {PRM_Name("float32", "32-bit Float"), PRM_Name("savehalf", "16-bit Float on Save"),
+                                                 PRM_Name(0, 0)};
+        static PRM_ChoiceList thePrecisionChoiceList(PRM_CHOICELIST_SINGLE, thePrecisionChoices);
+
+        static PRM_Name theOutputTimingsName(OUTPUT_TIMINGS_PARAM_NAME, "Output Decode Timings");
+        static PRM_Default theOutputTimingsDefault(0);
+
         static PRM_Name theReloadCacheName(REFRESH_CALLBACK_PARAM_NAME, "Reload Cache");
         static PRM_Callback theReloadCallback{[](void* node, int index, fpreal64 time, const PRM_Template* tplate) -> int {
             auto self = static_cast<SOP_ZibraVDBDecompressor*>(node);
+            self->m_RegisteredFileKey.reset();
+            self->m_FramePrefetcher.Reset();
             self->deleteCookedData();
             self->refreshGdp();
             return 1;
         }};
 
+        static PRM_Name thePrefetchName(PREFETCH_PARAM_NAME, "Prefetch Frames During Playback");
+        static PRM_Default thePrefetchDefault(1);
+
+        static PRM_Name thePrefetchCountName(PREFETCH_COUNT_PARAM_NAME, "Prefetch Frame Count");
+        static PRM_Default thePrefetchCountDefault(4);
+        static PRM_Range thePrefetchCountRange(PRM_RANGE_RESTRICTED, 1, PRM_RANGE_UI, 16);
+        static PRM_Conditional thePrefetchCountCondition("{ prefetch == \"off\" }", PRM_CONDTYPE_DISABLE);
+
+        static PRM_Name theMemoryLimitName(MEMORY_LIMIT_PARAM_NAME, "Decompression Memory Limit (MB)");
+        static PRM_Default theMemoryLimitDefault(0);
+        static PRM_Range theMemoryLimitRange(PRM_RANGE_RESTRICTED, 0, PRM_RANGE_UI, 4096);
+
         static PRM_Name theOpenPluginManagementButtonName(OPEN_PLUGIN_MANAGEMENT_BUTTON_NAME, "Open Plugin Management");
 
         static PRM_Template templateList[] = {
             PRM_Template(PRM_FILE, 1, &theFileName, &theFileDefault), PRM_Template(PRM_INT, 1, &theFrameName, &theFrameDefault),
+            PRM_Template(PRM_STRING, 1, &theChannelsName, &theChannelsDefault, &theChannelsChoiceList),
+            PRM_Template(PRM_TOGGLE, 1, &theUseROIName, &theUseROIDefault),
+            PRM_Template(PRM_ORD, 1, &theROISpaceName, &theROISpaceDefault, &theROISpaceChoiceList, nullptr, nullptr, nullptr, 1, nullptr,
+                         &theROICondition),
+            PRM_Template(PRM_XYZ, 3, &theROIMinName, theROIMinDefault, nullptr, nullptr, nullptr, nullptr, 1, nullptr, &theROICondition),
+            PRM_Template(PRM_XYZ, 3, &theROIMaxName, theROIMaxDefault, nullptr, nullptr, nullptr, nullptr, 1, nullptr, &theROICondition),
+            PRM_Template(PRM_TOGGLE, 1, &theDeactivateBackgroundName, &theDeactivateBackgroundDefault),
+            PRM_Template(PRM_FLT, 1, &theBackgroundToleranceName, &theBackgroundToleranceDefault, nullptr, &theBackgroundToleranceRange,
+                         nullptr, nullptr, 1, nullptr, &theBackgroundToleranceCondition),
+            PRM_Template(PRM_TOGGLE, 1, &theCollapseUniformName, &theCollapseUniformDefault),
+            PRM_Template(PRM_FLT, 1, &theUniformToleranceName, &theUniformToleranceDefault, nullptr, &theUniformToleranceRange, nullptr,
+                         nullptr, 1, nullptr, &theUniformToleranceCondition),
+            PRM_Template(PRM_ORD, 1, &thePrecisionName, &thePrecisionDefault, &thePrecisionChoiceList),
             PRM_Template(PRM_CALLBACK, 1, &theReloadCacheName, nullptr, nullptr, nullptr, theReloadCallback),
+            PRM_Template(PRM_TOGGLE, 1, &thePrefetchName, &thePrefetchDefault),
+            PRM_Template(PRM_INT, 1, &thePrefetchCountName, &thePrefetchCountDefault, nullptr, &thePrefetchCountRange, nullptr, nullptr, 1,
+                         nullptr, &thePrefetchCountCondition),
+            PRM_Template(PRM_INT, 1, &theMemoryLimitName, &theMemoryLimitDefault, nullptr, &theMemoryLimitRange),
+            PRM_Template(PRM_TOGGLE, 1, &theOutputTimingsName, &theOutputTimingsDefault),
             PRM_Template(PRM_CALLBACK, 1, &theOpenPluginManagementButtonName, nullptr, nullptr, nullptr,
                          &SOP_ZibraVDBDecompressor::OpenManagementWindow),
             PRM_Template()};
@@ -55,6 +129,9 @@ namespace Zibra::ZibraVDBDecompressor
 
     OP_ERROR SOP_ZibraVDBDecompressor::cookMySop(OP_Context& context)
     {
+        const Helpers::DecodeTimings::Clock::time_point cookStart = Helpers::DecodeTimings::Clock::now();
+        m_LastCookTimings.reset();
+
         gdp->clearAndDestroy();
 
         if (!LibraryUtils::IsPlatformSupported())
@@ -82,26 +159,45 @@ namespace Zibra::ZibraVDBDecompressor
         }
 
         m_DecompressorManager.Initialize();
+        m_DecompressorManager.ResetTimings();
 
-        auto status = m_DecompressorManager.RegisterDecompressor(filename);
-        switch (status)
+        CE::ReturnCode status = CE::ZCE_SUCCESS;
+        if (!IsRegisteredFileUpToDate(filename))
         {
-        case CE::ZCE_SUCCESS:
-            break;
-        case CE::ZCE_ERROR_LICENSE_INCOMPATIBLE_FILE:
-            addError(SOP_MESSAGE, "Your license does not allow for decompression of this file.");
-            return error(context);
-        case CE::ZCE_ERROR_LICENSE_ERROR:
-            addError(SOP_MESSAGE, ZIBRAVDB_ERROR_MESSAGE_LICENSE_ERROR);
-            return error(context);
-        case CE::ZCE_ERROR_NOT_FOUND:
-            addError(SOP_MESSAGE, ZIBRAVDB_ERROR_MESSAGE_FILE_NOT_FOUND);
-            return error(context);
-        default: {
-            std::string errorMessage = "Failed to initialize decompressor: " + LibraryUtils::ErrorCodeToString(status);
-            addError(SOP_MESSAGE, errorMessage.c_str());
-            return error(context);
-        }
+            m_RegisteredFileKey.reset();
+            m_FramePrefetcher.Reset();
+            m_LastCookedFrameIndex.reset();
+            status = m_DecompressorManager.RegisterDecompressor(filename);
+            switch (status)
+            {
+            case CE::ZCE_SUCCESS:
+                break;
+            case CE::ZCE_ERROR_LICENSE_INCOMPATIBLE_FILE:
+                addError(SOP_MESSAGE, "Your license does not allow for decompression of this file.");
+                return error(context);
+            case CE::ZCE_ERROR_LICENSE_ERROR:
+                addError(SOP_MESSAGE, ZIBRAVDB_ERROR_MESSAGE_LICENSE_ERROR);
+                return error(context);
+            case CE::ZCE_ERROR_NOT_FOUND:
+                addError(SOP_MESSAGE, ZIBRAVDB_ERROR_MESSAGE_FILE_NOT_FOUND);
+                return error(context);
+            default: {
+                std::string errorMessage = "Failed to initialize decompressor: " + LibraryUtils::ErrorCodeToString(status);
+                addError(SOP_MESSAGE, errorMessage.c_str());
+                return error(context);
+            }
+            }
+            m_RegisteredFileKey = MakeRegisteredFileKey(filename, m_DecompressorManager.GetRegisteredFileName());
+
+            const SequenceInfo sequenceInfo = m_DecompressorManager.GetSequenceInfo();
+            m_AvailableChannels.clear();
+            for (size_t i = 0; i < sequenceInfo.channelCount; ++i)
+            {
+                if (sequenceInfo.channels[i] != nullptr)
+                {
+                    m_AvailableChannels.emplace_back(sequenceInfo.channels[i]);
+                }
+            }
         }
 
         if (m_DecompressorManager.GetWarning().length() > 0)
@@ -120,57 +216,297 @@ namespace Zibra::ZibraVDBDecompressor
             return error(context);
         }
 
-        frameContainer = m_DecompressorManager.FetchFrame(frameIndex);
-        if (frameContainer->GetInfo().spatialBlockCount == 0)
+        const Helpers::FrameDecodeOptions decodeOptions = ParseDecodeOptions(context.getTime());
+
+        const std::string registeredFileName = m_DecompressorManager.GetRegisteredFileName().toStdString();
+        const bool isPrefetchEnabled = evalInt(PREFETCH_PARAM_NAME, 0, context.getTime()) != 0;
+        const int prefetchCount = static_cast<int>(evalInt(PREFETCH_COUNT_PARAM_NAME, 0, context.getTime()));
+
+        // 0 means limit is selected automatically
+        const size_t memoryLimitPerResource = static_cast<size_t>(evalInt(MEMORY_LIMIT_PARAM_NAME, 0, context.getTime())) * 1024 * 1024;
+        m_DecompressorManager.SetMemoryLimitPerResource(memoryLimitPerResource);
+        m_FramePrefetcher.SetMemoryLimitPerResource(memoryLimitPerResource);
+
+        int playbackDirection = 0;
+        if (m_LastCookedFrameIndex.has_value() && std::abs(frameIndex - *m_LastCookedFrameIndex) == 1)
         {
-            frameContainer->Release();
-            return error(context);
+            playbackDirection = static_cast<int>(frameIndex - *m_LastCookedFrameIndex);
+        }
+        m_LastCookedFrameIndex = frameIndex;
+
+        openvdb::GridPtrVec vdbGrids = {};
+        FramePrefetcher::PrefetchedFrame prefetchedFrame{};
+        const bool isPrefetched =
+            isPrefetchEnabled && m_FramePrefetcher.TryTakeFrame(registeredFileName, decodeOptions, frameIndex, prefetchedFrame);
+        if (isPrefetched)
+        {
+            frameContainer = prefetchedFrame.frameContainer;
+            vdbGrids = std::move(prefetchedFrame.grids);
+        }
+        else
+        {
+            // Frame container is a metadata snapshot, since frames taken from DecodedFrameCache are not read from file.
+            status = m_DecompressorManager.DecompressFrameCached(frameIndex, decodeOptions, &vdbGrids, &frameContainer);
+            if (status == CE::ZCE_ERROR_NOT_FOUND)
+            {
+                addError(SOP_MESSAGE, "Error when trying to fetch frame.");
+                return error(context);
+            }
+            if (status != CE::ZCE_SUCCESS)
+            {
+                addError(SOP_MESSAGE, "Error when trying to decompress frame.");
+                return error(context);
+            }
         }
 
+        // Prefetching starts only after requested frame is decompressed, so it never competes with it for the device.
+        // Scrubbing or jumping drops prefetch window, so stale frames don't keep occupying the device.
+        auto updatePrefetch = [&]() {
+            if (isPrefetchEnabled && playbackDirection != 0)
+            {
+                m_FramePrefetcher.Prefetch(registeredFileName, decodeOptions, frameIndex, playbackDirection, prefetchCount, frameRange);
+            }
+            else
+            {
+                m_FramePrefetcher.Reset();
+            }
+        };
+
         if (frameContainer == nullptr)
         {
             addError(SOP_MESSAGE, "Error when trying to fetch frame.");
             return error(context);
         }
 
-        auto gridShuffle = m_DecompressorManager.DeserializeGridShuffleInfo(frameContainer);
-
-        openvdb::GridPtrVec vdbGrids = {};
-        status = m_DecompressorManager.DecompressFrame(frameContainer, gridShuffle, &vdbGrids);
-        m_DecompressorManager.ReleaseGridShuffleInfo(gridShuffle);
-        if (status != CE::ZCE_SUCCESS)
+        if (frameContainer->GetInfo().spatialBlockCount == 0)
         {
+            updatePrefetch();
             frameContainer->Release();
-            addError(SOP_MESSAGE, "Error when trying to decompress frame.");
             return error(context);
         }
 
-        gdp->addStringTuple(GA_ATTRIB_PRIMITIVE, "name", 1);
-        GA_RWHandleS nameAttr{gdp->findPrimitiveAttribute("name")};
+        updatePrefetch();
+
+        Helpers::DecodeTimings timings = m_DecompressorManager.GetTimings();
+
         for (size_t i = 0; i < vdbGrids.size(); ++i)
         {
-            const openvdb::GridBase::Ptr grid = vdbGrids[i];
+            // Grid is moved out, so only the primitive and DecodedFrameCache reference the tree.
+            // Decoded frames that fit into the budget are inserted into DecodedFrameCache, so the tree is usually shared
+            // with the cache and GEO_PrimVDB deep copies it on the first downstream write. Cached frame is never modified in place.
+            // Only frames larger than the whole cache budget end up solely owned by the primitive.
+            openvdb::GridBase::Ptr grid = std::move(vdbGrids[i]);
 
             if (!grid)
             {
-                addError(SOP_MESSAGE, ("Failed to decompress channel: "s + frameContainer->GetInfo().channels[i].name).c_str());
+                addError(SOP_MESSAGE, "Failed to decompress grid.");
                 continue;
             }
 
-            GU_PrimVDB* vdbPrim = GU_PrimVDB::build(gdp);
-            nameAttr.set(vdbPrim->getMapOffset(), grid->getName());
-            vdbPrim->setGrid(*grid);
+            GU_PrimVDB* vdbPrim = nullptr;
+            {
+                Helpers::ScopedStageTimer timer(&timings, Helpers::DecodeTimings::Stage::BuildPrimitives);
+                // Primitive shares the tree with the grid instead of copying it. Name attribute is created and set by buildFromGrid.
+                vdbPrim = GU_PrimVDB::buildFromGrid(*gdp, grid, nullptr, grid->getName().c_str());
+            }
 
+            if (!vdbPrim)
+            {
+                addError(SOP_MESSAGE, "Failed to create VDB primitive.");
+                continue;
+            }
+
+            UT_ASSERT(&vdbPrim->getConstGrid().constBaseTree() == &grid->constBaseTree());
+            grid.reset();
+
+            Helpers::ScopedStageTimer timer(&timings, Helpers::DecodeTimings::Stage::ApplyMetadata);
             Utils::MetadataHelper::ApplyGridMetadata(gdp, vdbPrim, frameContainer);
         }
 
-        Utils::MetadataHelper::ApplyDetailMetadata(gdp, frameContainer);
+        {
+            Helpers::ScopedStageTimer timer(&timings, Helpers::DecodeTimings::Stage::ApplyMetadata);
+            Utils::MetadataHelper::ApplyDetailMetadata(gdp, frameContainer);
+        }
 
         frameContainer->Release();
 
+        timings.Add(Helpers::DecodeTimings::Stage::Total, Helpers::DecodeTimings::Clock::now() - cookStart);
+        ReportTimings(timings, context.getTime(), registeredFileName, frameIndex, isPrefetched);
+
         return error(context);
     }
 
+    void SOP_ZibraVDBDecompressor::ReportTimings(const Helpers::DecodeTimings& timings, fpreal t, const std::string& filename,
+                                                 exint frameIndex, bool isPrefetched) noexcept
+    {
+        m_LastCookTimings = timings;
+        m_IsLastCookedFramePrefetched = isPrefetched;
+
+        if (evalInt(OUTPUT_TIMINGS_PARAM_NAME, 0, t) != 0)
+        {
+            for (size_t i = 0; i < size_t(Helpers::DecodeTimings::Stage::Count); ++i)
+            {
+                const auto stage = static_cast<Helpers::DecodeTimings::Stage>(i);
+                const std::string attributeName = "zibravdb_time_"s + Helpers::DecodeTimings::GetStageName(stage) + "_ms";
+                GA_RWHandleF timingAttr{gdp->addFloatTuple(GA_ATTRIB_DETAIL, attributeName.c_str(), 1)};
+                timingAttr.set(GA_Offset(0), static_cast<fpreal32>(timings.GetMilliseconds(stage)));
+            }
+        }
+
+        std::optional<std::string> logPath = Helpers::GetDecodeTimingsLogPath();
+        if (logPath.has_value())
+        {
+            nlohmann::json entry = nlohmann::json::object();
+            entry["node"] = getFullPath().toStdString();
+            entry["file"] = filename;
+            entry["frame"] = frameIndex;
+            entry["prefetched"] = isPrefetched;
+            entry["timings_ms"] = timings.ToJSON();
+            Helpers::AppendDecodeTimingsLog(logPath.value(), entry);
+        }
+    }
+
+    void SOP_ZibraVDBDecompressor::getNodeSpecificInfoText(OP_Context& context, OP_NodeInfoParms& parms)
+    {
+        SOP_Node::getNodeSpecificInfoText(context, parms);
+
+        if (!m_LastCookTimings.has_value())
+        {
+            return;
+        }
+
+        parms.append(m_IsLastCookedFramePrefetched ? "Decode timings (frame was prefetched):\n" : "Decode timings:\n");
+        parms.append(m_LastCookTimings->FormatText().c_str());
+    }
+
+    std::optional<SOP_ZibraVDBDecompressor::RegisteredFileKey> SOP_ZibraVDBDecompressor::MakeRegisteredFileKey(
+        const UT_String& filename, const UT_String& resolvedFileName) noexcept
+    {
+        RegisteredFileKey key{};
+        key.filename = filename.toStdString();
+        key.resolvedFileName = resolvedFileName.toStdString();
+
+        std::error_code errorCode;
+        const std::filesystem::path resolvedPath = key.resolvedFileName;
+        key.fileSize = std::filesystem::file_size(resolvedPath, errorCode);
+        if (errorCode)
+        {
+            return std::nullopt;
+        }
+        key.lastWriteTime = std::filesystem::last_write_time(resolvedPath, errorCode);
+        if (errorCode)
+        {
+            return std::nullopt;
+        }
+        return key;
+    }
+
+    bool SOP_ZibraVDBDecompressor::IsRegisteredFileUpToDate(const UT_String& filename) const noexcept
+    {
+        if (!m_RegisteredFileKey.has_value() || m_RegisteredFileKey->filename != filename.toStdString())
+        {
+            return false;
+        }
+
+        // Only resolved file is checked, so frame changes don't repeat file name patching.
+        std::optional<RegisteredFileKey> currentKey = MakeRegisteredFileKey(filename, m_RegisteredFileKey->resolvedFileName.c_str());
+        if (!currentKey.has_value())
+        {
+            return false;
+        }
+        return currentKey->fileSize == m_RegisteredFileKey->fileSize && currentKey->lastWriteTime == m_RegisteredFileKey->lastWriteTime;
+    }
+
+    void SOP_ZibraVDBDecompressor::BuildChannelsChoiceList(void* data, PRM_Name* choiceNames, int maxListSize, const PRM_SpareData*,
+                                                           const PRM_Parm*)
+    {
+        if (!choiceNames || maxListSize <= 0)
+        {
+            return;
+        }
+
+        auto node = static_cast<SOP_ZibraVDBDecompressor*>(data);
+        if (!node)
+        {
+            return;
+        }
+
+        int choiceIndex = 0;
+
+        if (choiceIndex < maxListSize - 1)
+        {
+            choiceNames[choiceIndex].setToken("*");
+            choiceNames[choiceIndex].setLabel("All Channels");
+            choiceIndex++;
+        }
+
+        for (const std::string& channelName : node->m_AvailableChannels)
+        {
+            if (choiceIndex >= maxListSize - 1)
+                break;
+
+            choiceNames[choiceIndex].setToken(channelName.c_str());
+            choiceNames[choiceIndex].setLabel(channelName.c_str());
+            choiceIndex++;
+        }
+
+        if (choiceIndex < maxListSize)
+        {
+            choiceNames[choiceIndex].setToken(nullptr);
+            choiceNames[choiceIndex].setLabel(nullptr);
+        }
+    }
+
+    // Supported channels formats:
+    // "*" - decompresses all channels, also when combined with other names, since menu toggles names in and out of the list
+    // "channel1 channel2 grid3" - space-separated channel or grid names
+    Helpers::FrameDecodeOptions SOP_ZibraVDBDecompressor::ParseDecodeOptions(fpreal t) const
+    {
+        using namespace Helpers;
+
+        FrameDecodeOptions options{};
+
+        if (evalInt(USE_ROI_PARAM_NAME, 0, t) != 0)
+        {
+            RegionOfInterest regionOfInterest{};
+            regionOfInterest.space = evalInt(ROI_SPACE_PARAM_NAME, 0, t) == 0 ? RegionOfInterest::Space::World : RegionOfInterest::Space::Index;
+            const openvdb::Vec3d regionMin{evalFloat(ROI_MIN_PARAM_NAME, 0, t), evalFloat(ROI_MIN_PARAM_NAME, 1, t),
+                                           evalFloat(ROI_MIN_PARAM_NAME, 2, t)};
+            const openvdb::Vec3d regionMax{evalFloat(ROI_MAX_PARAM_NAME, 0, t), evalFloat(ROI_MAX_PARAM_NAME, 1, t),
+                                           evalFloat(ROI_MAX_PARAM_NAME, 2, t)};
+            regionOfInterest.bbox = openvdb::BBoxd{regionMin, regionMax};
+            options.regionOfInterest = regionOfInterest;
+        }
+
+        if (evalInt(DEACTIVATE_BACKGROUND_PARAM_NAME, 0, t) != 0)
+        {
+            options.deactivateBackground = true;
+            options.backgroundTolerance = static_cast<float>(evalFloat(BACKGROUND_TOLERANCE_PARAM_NAME, 0, t));
+        }
+        if (evalInt(COLLAPSE_UNIFORM_PARAM_NAME, 0, t) != 0)
+        {
+            options.collapseUniformBlocks = true;
+            options.uniformTolerance = static_cast<float>(evalFloat(UNIFORM_TOLERANCE_PARAM_NAME, 0, t));
+        }
+        options.precision = evalInt(PRECISION_PARAM_NAME, 0, t) == 0 ? CE::Addons::OpenVDBUtils::GridPrecision::Float32
+                                                                      : CE::Addons::OpenVDBUtils::GridPrecision::Float32SavedAsHalf;
+
+        UT_String channels;
+        evalString(channels, CHANNELS_PARAM_NAME, 0, t);
+        std::istringstream iss(channels.toStdString());
+        std::string channel;
+        while (iss >> channel)
+        {
+            if (channel == "*")
+            {
+                options.gridNames.clear();
+                break;
+            }
+            options.gridNames.insert(channel);
+        }
+        return options;
+    }
+
     int SOP_ZibraVDBDecompressor::OpenManagementWindow(void* data, int index, fpreal32 time, const PRM_Template* tplate)
     {
         PluginManagementWindow::ShowWindow();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FramePrefetcher.h"
 #include "utils/DecompressorManager.h"
 
 namespace Zibra::ZibraVDBDecompressor
@@ -12,10 +13,34 @@ namespace Zibra::ZibraVDBDecompressor
     private:
         static constexpr const char* FILENAME_PARAM_NAME = "filename";
         static constexpr const char* FRAME_PARAM_NAME = "frame";
+        static constexpr const char* CHANNELS_PARAM_NAME = "channels";
+        static constexpr const char* USE_ROI_PARAM_NAME = "useroi";
+        static constexpr const char* ROI_SPACE_PARAM_NAME = "roispace";
+        static constexpr const char* ROI_MIN_PARAM_NAME = "roimin";
+        static constexpr const char* ROI_MAX_PARAM_NAME = "roimax";
+        static constexpr const char* DEACTIVATE_BACKGROUND_PARAM_NAME = "deactivatebackground";
+        static constexpr const char* BACKGROUND_TOLERANCE_PARAM_NAME = "backgroundtolerance";
+        static constexpr const char* COLLAPSE_UNIFORM_PARAM_NAME = "collapseuniform";
+        static constexpr const char* UNIFORM_TOLERANCE_PARAM_NAME = "uniformtolerance";
+        static constexpr const char* PRECISION_PARAM_NAME = "precision";
         static constexpr const char* REFRESH_CALLBACK_PARAM_NAME = "reload";
+        static constexpr const char* PREFETCH_PARAM_NAME = "prefetch";
+        static constexpr const char* PREFETCH_COUNT_PARAM_NAME = "prefetchcount";
+        static constexpr const char* MEMORY_LIMIT_PARAM_NAME = "memorylimit";
+        static constexpr const char* OUTPUT_TIMINGS_PARAM_NAME = "outputtimings";
         static constexpr const char* OPEN_PLUGIN_MANAGEMENT_BUTTON_NAME = "openmanagement";
         static constexpr const char* CORE_LIB_PATH_FIELD_NAME = "corelibpath";
 
+        // Identifies file that currently registered decompressor was created for.
+        // Decompressor is re-registered only when any of these change, so cooking next frame of the same file is cheap.
+        struct RegisteredFileKey
+        {
+            std::string filename;
+            std::string resolvedFileName;
+            uintmax_t fileSize = 0;
+            std::filesystem::file_time_type lastWriteTime{};
+        };
+
     public:
         static OP_Node* Constructor(OP_Network* net, const char* name, OP_Operator* op) noexcept;
         static PRM_Template* GetTemplateList() noexcept;
@@ -26,11 +51,29 @@ namespace Zibra::ZibraVDBDecompressor
 
     public:
         OP_ERROR cookMySop(OP_Context& context) final;
+        void getNodeSpecificInfoText(OP_Context& context, OP_NodeInfoParms& parms) final;
 
         static int OpenManagementWindow(void* data, int index, fpreal32 time, const PRM_Template* tplate);
 
     private:
+        static void BuildChannelsChoiceList(void* data, PRM_Name* choiceNames, int maxListSize, const PRM_SpareData*, const PRM_Parm*);
+        Helpers::FrameDecodeOptions ParseDecodeOptions(fpreal t) const;
+        // Stores timings for info panel, and outputs them as detail attributes and to log file when enabled.
+        void ReportTimings(const Helpers::DecodeTimings& timings, fpreal t, const std::string& filename, exint frameIndex,
+                           bool isPrefetched) noexcept;
+        static std::optional<RegisteredFileKey> MakeRegisteredFileKey(const UT_String& filename,
+                                                                      const UT_String& resolvedFileName) noexcept;
+        bool IsRegisteredFileUpToDate(const UT_String& filename) const noexcept;
+
         Helpers::DecompressorManager m_DecompressorManager;
+        std::optional<RegisteredFileKey> m_RegisteredFileKey;
+        // Channels of registered file, used for channels parameter menu
+        std::vector<std::string> m_AvailableChannels;
+        FramePrefetcher m_FramePrefetcher;
+        // Consecutive cooks of neighbour frames are treated as playback and trigger prefetch in the same direction
+        std::optional<exint> m_LastCookedFrameIndex;
+        std::optional<Helpers::DecodeTimings> m_LastCookTimings;
+        bool m_IsLastCookedFramePrefetched = false;
     };
 
     class SOP_ZibraVDBDecompressor_Operator final : public OP_Operator
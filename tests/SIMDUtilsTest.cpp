@@ -0,0 +1,199 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <Zibra/CE/Addons/SIMDUtils.h>
+
+namespace
+{
+    using namespace Zibra::CE;
+    using namespace Zibra::CE::Addons::SIMDUtils;
+
+    int g_FailureCount = 0;
+
+    void Check(bool condition, const char* kernelName, const char* description) noexcept
+    {
+        if (!condition)
+        {
+            std::fprintf(stderr, "FAILED [%s]: %s\n", kernelName, description);
+            ++g_FailureCount;
+        }
+    }
+
+    uint32_t FloatBits(float value) noexcept
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    bool IsNearlyEqual(float a, float b) noexcept
+    {
+        return std::abs(a - b) <= 1e-4f * std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+    }
+
+    // Sequential reference of statistics that FrameLoader used to compute in separate loop, with max seeded correctly.
+    BlockStatistics ReferenceStatistics(const float* src, size_t count, size_t stride, size_t componentIdx) noexcept
+    {
+        BlockStatistics result{};
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float value = src[i * stride + componentIdx];
+            if (std::isnan(value))
+            {
+                continue;
+            }
+            result.min = std::min(result.min, value);
+            result.max = std::max(result.max, value);
+            result.positiveSum += value > 0.0f ? value : 0.0f;
+            result.negativeSum += value < 0.0f ? value : 0.0f;
+        }
+        return result;
+    }
+
+    using PackKernel = void (*)(float*, const float*, size_t, size_t, BlockStatistics*);
+    using ConvertKernel = void (*)(float*, const uint16_t*, size_t, size_t, ValueRange*);
+
+    template <size_t Stride>
+    void TestPackWithStatistics(PackKernel kernel, const char* kernelName, const std::vector<float>& src, size_t count) noexcept
+    {
+        for (size_t componentIdx = 0; componentIdx < Stride; ++componentIdx)
+        {
+            std::vector<float> dst(count, 0.0f);
+            BlockStatistics statistics{};
+            kernel(dst.data(), src.data(), count, componentIdx, &statistics);
+
+            bool isPacked = true;
+            for (size_t i = 0; i < count; ++i)
+            {
+                isPacked = isPacked && FloatBits(dst[i]) == FloatBits(src[i * Stride + componentIdx]);
+            }
+            Check(isPacked, kernelName, "packed values differ from source");
+
+            const BlockStatistics reference = ReferenceStatistics(src.data(), count, Stride, componentIdx);
+            Check(statistics.min == reference.min, kernelName, "min differs from reference");
+            Check(statistics.max == reference.max, kernelName, "max differs from reference");
+            Check(IsNearlyEqual(statistics.positiveSum, reference.positiveSum), kernelName, "positive sum differs from reference");
+            Check(IsNearlyEqual(statistics.negativeSum, reference.negativeSum), kernelName, "negative sum differs from reference");
+        }
+    }
+
+    template <size_t Stride>
+    void TestPackKernel(PackKernel kernel, const char* kernelName) noexcept
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+        // Count is not multiple of vector width, so tail is covered too.
+        for (size_t count : {size_t(3), size_t(13), size_t(SPARSE_BLOCK_VOXEL_COUNT)})
+        {
+            std::vector<float> mixed(count * Stride);
+            for (float& value : mixed)
+            {
+                value = distribution(generator);
+            }
+            TestPackWithStatistics<Stride>(kernel, kernelName, mixed, count);
+
+            // Max seeded with numeric_limits<float>::min() reported positive max for block of negative values.
+            std::vector<float> negative(count * Stride);
+            for (float& value : negative)
+            {
+                value = -1.0f - std::abs(distribution(generator));
+            }
+            TestPackWithStatistics<Stride>(kernel, kernelName, negative, count);
+
+            std::vector<float> withNaN = mixed;
+            withNaN[0] = std::numeric_limits<float>::quiet_NaN();
+            withNaN[withNaN.size() - 1] = std::numeric_limits<float>::quiet_NaN();
+            TestPackWithStatistics<Stride>(kernel, kernelName, withNaN, count);
+        }
+
+        std::vector<float> negative(SPARSE_BLOCK_VOXEL_COUNT * Stride, -2.0f);
+        negative[5 * Stride] = -0.5f;
+        BlockStatistics statistics{};
+        std::vector<float> dst(SPARSE_BLOCK_VOXEL_COUNT);
+        kernel(dst.data(), negative.data(), SPARSE_BLOCK_VOXEL_COUNT, 0, &statistics);
+        Check(statistics.max == -0.5f, kernelName, "max of negative block is not its largest value");
+        Check(statistics.positiveSum == 0.0f, kernelName, "positive sum of negative block is not zero");
+    }
+
+    template <size_t Stride>
+    void TestConvertKernel(ConvertKernel kernel, ConvertKernel kernelWithRange, const char* kernelName) noexcept
+    {
+        constexpr size_t VALUE_COUNT = 1 << 16;
+        std::vector<uint16_t> src(VALUE_COUNT);
+        for (size_t i = 0; i < VALUE_COUNT; ++i)
+        {
+            src[i] = static_cast<uint16_t>(i);
+        }
+
+        std::vector<float> dst(VALUE_COUNT * Stride, 0.0f);
+        kernel(dst.data(), src.data(), VALUE_COUNT, Stride - 1, nullptr);
+
+        bool isBitExact = true;
+        for (size_t i = 0; i < VALUE_COUNT; ++i)
+        {
+            isBitExact = isBitExact && FloatBits(dst[i * Stride + Stride - 1]) == FloatBits(Float16ToFloat32(src[i]));
+        }
+        Check(isBitExact, kernelName, "conversion is not bit exact with Float16ToFloat32");
+
+        const float* converted = dst.data() + Stride - 1;
+        Check(converted[0x7bff * Stride] == 65504.0f, kernelName, "largest finite half is not 65504");
+        Check(converted[0x0001 * Stride] == 0.0f, kernelName, "denormal is not flushed to zero");
+        Check(converted[0x7c00 * Stride] == std::numeric_limits<float>::infinity(), kernelName, "+inf is not propagated");
+        Check(converted[0xfc00 * Stride] == -std::numeric_limits<float>::infinity(), kernelName, "-inf is not propagated");
+        Check(std::isnan(converted[0x7e00 * Stride]), kernelName, "NaN is not propagated");
+
+        // Finite values only, so range is comparable with reference.
+        const size_t finiteCount = 0x7c00;
+        ValueRange range{};
+        kernelWithRange(dst.data(), src.data(), finiteCount, Stride - 1, &range);
+        Check(range.min == 0.0f && range.max == 65504.0f, kernelName, "range of finite values is wrong");
+    }
+
+    template <size_t Stride>
+    void TestKernels() noexcept
+    {
+        TestPackKernel<Stride>(
+            [](float* dst, const float* src, size_t count, size_t componentIdx, BlockStatistics* statistics) {
+                Detail::PackWithStatisticsTail<Stride>(dst, src, 0, count, componentIdx, statistics);
+            },
+            "Scalar");
+        TestConvertKernel<Stride>(Detail::ConvertFloat16ToFloat32Scalar<Stride, false>,
+                                  Detail::ConvertFloat16ToFloat32Scalar<Stride, true>, "Scalar");
+#if ZIB_SIMD_X86
+        TestPackKernel<Stride>(Detail::PackWithStatisticsSSE2<Stride>, "SSE2");
+        TestConvertKernel<Stride>(Detail::ConvertFloat16ToFloat32SSE2<Stride, false>, Detail::ConvertFloat16ToFloat32SSE2<Stride, true>,
+                                  "SSE2");
+        if (GetInstructionSet() == InstructionSet::AVX2)
+        {
+            TestPackKernel<Stride>(Detail::PackWithStatisticsAVX2<Stride>, "AVX2");
+            TestConvertKernel<Stride>(Detail::ConvertFloat16ToFloat32AVX2<Stride, false>,
+                                      Detail::ConvertFloat16ToFloat32AVX2<Stride, true>, "AVX2");
+        }
+        else
+        {
+            std::printf("AVX2 is not supported, skipping AVX2 kernels.\n");
+        }
+#endif
+    }
+} // namespace
+
+int main()
+{
+    TestKernels<1>();
+    TestKernels<3>();
+    TestKernels<4>();
+
+    if (g_FailureCount != 0)
+    {
+        std::fprintf(stderr, "%d checks failed.\n", g_FailureCount);
+        return 1;
+    }
+    std::printf("All checks passed.\n");
+    return 0;
+}